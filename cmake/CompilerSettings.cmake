@@ -54,3 +54,9 @@ if(COMPILER_GNU OR COMPILER_CLANG)
 elseif(COMPILER_MSVC)
   add_compile_options(/W4 /permissive-)
 endif()
+
+# 日志设置：开启后 qDebug/qCDebug 语句连同参数求值在编译期被移除
+option(LOG_NO_DEBUG_OUTPUT "Compile out debug-level log statements" OFF)
+if(LOG_NO_DEBUG_OUTPUT)
+  add_compile_definitions(QT_NO_DEBUG_OUTPUT)
+endif()
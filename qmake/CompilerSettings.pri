@@ -11,3 +11,8 @@ DEFINES += \
 # add debug info
 QMAKE_CXXFLAGS_RELEASE += $$QMAKE_CFLAGS_RELEASE_WITH_DEBUGINFO
 QMAKE_LFLAGS_RELEASE += $$QMAKE_LFLAGS_RELEASE_WITH_DEBUGINFO
+
+# 日志设置：CONFIG += log_no_debug_output 后 qDebug/qCDebug 语句在编译期被移除
+log_no_debug_output {
+    DEFINES += QT_NO_DEBUG_OUTPUT
+}
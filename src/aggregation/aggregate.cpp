@@ -3,8 +3,11 @@
 
 #include "aggregate.h"
 
-#include <QWriteLocker>
 #include <QDebug>
+#include <QThread>
+#include <QWriteLocker>
+
+#include <atomic>
 
 /*!
     \namespace Aggregation
@@ -130,13 +133,116 @@
 
 namespace Aggregation {
 
+namespace {
+
+// Immutable copy of the aggregate relations that readers use without taking
+// Aggregate::lock(). Writers publish a new one after each change.
+struct Snapshot
+{
+    QHash<QObject *, Aggregate *> parents;
+    QHash<const Aggregate *, QObjectList> components;
+};
+
+// Readers announce themselves in one of two sets of counters selected by the
+// epoch. Before a replaced snapshot is deleted, the writer flips the epoch twice
+// and waits for both sets to drain, so no reader can still be using it.
+// Each set is striped over cache lines, so that reader threads do not contend
+// on a shared counter.
+constexpr unsigned readerStripes = 32;
+
+struct alignas(64) ReaderCount
+{
+    std::atomic<int> count{0};
+};
+
+std::atomic<const Snapshot *> s_snapshot{nullptr}; // nullptr until the first aggregate
+std::atomic<unsigned> s_epoch{0};
+ReaderCount s_readers[2][readerStripes];
+
+unsigned readerStripe()
+{
+    static std::atomic<unsigned> nextStripe{0};
+    thread_local const unsigned stripe = nextStripe.fetch_add(1) % readerStripes;
+    return stripe;
+}
+
+class ReadGuard
+{
+public:
+    ReadGuard()
+        : m_count(s_readers[s_epoch.load() & 1][readerStripe()].count)
+    {
+        m_count.fetch_add(1);
+    }
+    ~ReadGuard() { m_count.fetch_sub(1); }
+
+    const Snapshot *snapshot() const { return s_snapshot.load(); }
+
+private:
+    std::atomic<int> &m_count;
+};
+
+void waitForReaders()
+{
+    for (int i = 0; i < 2; ++i) {
+        const unsigned slot = s_epoch.fetch_add(1) & 1;
+        for (const ReaderCount &readers : s_readers[slot]) {
+            while (readers.count.load() != 0)
+                QThread::yieldCurrentThread();
+        }
+    }
+}
+
+} // namespace
+
 /*!
     Returns the aggregate object of \a obj if there is one. Otherwise returns 0.
+
+    This function does not lock.
 */
 Aggregate *Aggregate::parentAggregate(QObject *obj)
 {
-    QReadLocker locker(&lock());
-    return aggregateMap().value(obj);
+    ReadGuard guard;
+    const Snapshot *snapshot = guard.snapshot();
+    return snapshot ? snapshot->parents.value(obj) : nullptr;
+}
+
+/*!
+    \internal
+
+    Returns the components of the aggregate \a obj belongs to, or \c std::nullopt
+    if it does not belong to an aggregate. Does not lock.
+*/
+std::optional<QObjectList> Aggregate::componentsOf(QObject *obj)
+{
+    ReadGuard guard;
+    const Snapshot *snapshot = guard.snapshot();
+    Aggregate *parent = snapshot ? snapshot->parents.value(obj) : nullptr;
+    if (!parent)
+        return std::nullopt;
+    return snapshot->components.value(parent);
+}
+
+/*!
+    \internal
+
+    Publishes the current state of \a aggregate, or removes it if \a removed is
+    \c true. Must be called with lock() locked for writing.
+*/
+void Aggregate::publish(const Aggregate *aggregate, bool removed)
+{
+    const Snapshot *old = s_snapshot.load();
+    auto snapshot = new Snapshot;
+    snapshot->parents = aggregateMap();
+    if (old)
+        snapshot->components = old->components;
+    if (removed)
+        snapshot->components.remove(aggregate);
+    else
+        snapshot->components.insert(aggregate, aggregate->m_components);
+    s_snapshot.store(snapshot);
+    waitForReaders();
+    delete old;
 }
 
 QHash<QObject *, Aggregate *> &Aggregate::aggregateMap()
@@ -166,6 +272,7 @@ Aggregate::Aggregate(enum PrivateConstructor)
 void Aggregate::construct()
 {
     aggregateMap().insert(this, this);
+    publish(this);
 }
 
 /*!
@@ -195,6 +302,7 @@ Aggregate::~Aggregate()
         components = m_components;
         m_components.clear();
         aggregateMap().remove(this);
+        publish(this, true);
     }
     qDeleteAll(components);
 }
@@ -205,6 +313,7 @@ void Aggregate::deleteSelf(QObject *obj)
         QWriteLocker locker(&lock());
         aggregateMap().remove(obj);
         m_components.removeAll(obj);
+        publish(this);
     }
     delete this;
 }
@@ -232,6 +341,7 @@ void Aggregate::add(QObject *component)
         m_components.append(component);
         connect(component, &QObject::destroyed, this, &Aggregate::deleteSelf);
         aggregateMap().insert(component, this);
+        publish(this);
     }
     emit changed();
 }
@@ -250,6 +360,7 @@ void Aggregate::remove(QObject *component)
         aggregateMap().remove(component);
         m_components.removeAll(component);
         disconnect(component, &QObject::destroyed, this, &Aggregate::deleteSelf);
+        publish(this);
     }
     emit changed();
 }
@@ -286,6 +397,7 @@ void aggregate(const QObjectList &components)
         QObject::connect(comp, &QObject::destroyed, agg, &Aggregate::deleteSelf);
         Aggregate::aggregateMap().insert(comp, agg);
     }
+    Aggregate::publish(agg);
 }
 
 } // namespace Aggregation
@@ -11,6 +11,8 @@
 #include <QReadWriteLock>
 #include <QReadLocker>
 
+#include <optional>
+
 namespace Aggregation {
 
 class AGGREGATION_EXPORT Aggregate : public QObject
@@ -25,8 +27,8 @@ public:
     void remove(QObject *component);
 
     template <typename T> T *component() {
-        QReadLocker locker(&lock());
-        for (QObject *component : std::as_const(m_components)) {
+        const QObjectList components = componentsOf(this).value_or(QObjectList());
+        for (QObject *component : components) {
             if (T *result = qobject_cast<T *>(component))
                 return result;
         }
@@ -34,9 +36,9 @@ public:
     }
 
     template <typename T> QList<T *> components() {
-        QReadLocker locker(&lock());
+        const QObjectList components = componentsOf(this).value_or(QObjectList());
         QList<T *> results;
-        for (QObject *component : std::as_const(m_components)) {
+        for (QObject *component : components) {
             if (T *result = qobject_cast<T *>(component)) {
                 results << result;
             }
@@ -45,6 +47,7 @@ public:
     }
 
     static Aggregate *parentAggregate(QObject *obj);
+    static std::optional<QObjectList> componentsOf(QObject *obj);
     static QReadWriteLock &lock();
 
 signals:
@@ -57,6 +60,7 @@ private:
     void construct();
 
     void deleteSelf(QObject *obj);
+    static void publish(const Aggregate *aggregate, bool removed = false);
 
     static QHash<QObject *, Aggregate *> &aggregateMap();
 
@@ -77,13 +81,14 @@ template <typename T> T *query(QObject *obj)
 {
     if (!obj)
         return nullptr;
-    T *result = qobject_cast<T *>(obj);
-    if (!result) {
-        QReadLocker locker(&Aggregate::lock());
-        Aggregate *parentAggregation = Aggregate::parentAggregate(obj);
-        result = (parentAggregation ? query<T>(parentAggregation) : nullptr);
+    if (T *result = qobject_cast<T *>(obj))
+        return result;
+    const QObjectList components = Aggregate::componentsOf(obj).value_or(QObjectList());
+    for (QObject *component : components) {
+        if (T *result = qobject_cast<T *>(component))
+            return result;
     }
-    return result;
+    return nullptr;
 }
 
 // get all components of a specific type via template function
@@ -98,13 +103,16 @@ template <typename T> QList<T *> query_all(QObject *obj)
 {
     if (!obj)
         return {};
-    QReadLocker locker(&Aggregate::lock());
-    Aggregate *parentAggregation = Aggregate::parentAggregate(obj);
+    const std::optional<QObjectList> components = Aggregate::componentsOf(obj);
     QList<T *> results;
-    if (parentAggregation)
-        results = query_all<T>(parentAggregation);
-    else if (T *result = qobject_cast<T *>(obj))
+    if (components) {
+        for (QObject *component : *components) {
+            if (T *result = qobject_cast<T *>(component))
+                results.append(result);
+        }
+    } else if (T *result = qobject_cast<T *>(obj)) {
         results.append(result);
+    }
     return results;
 }
 
@@ -0,0 +1,97 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+// Contention benchmark for Aggregation::query().
+//
+// Reader threads query components of a set of aggregates in a tight loop,
+// optionally while a writer thread keeps adding and removing a component.
+// Prints the total query throughput per reader thread count.
+
+#include <aggregation/aggregate.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace Aggregation;
+
+static const int aggregateCount = 1000;
+static const int durationMs = 500;
+
+static double run(const QObjectList &objects, int readerCount, bool withWriter, Aggregate *writerTarget)
+{
+    std::atomic_bool stop = false;
+    std::atomic<qint64> queries = 0;
+
+    auto reader = [&](int index) {
+        qint64 count = 0;
+        qsizetype found = 0;
+        for (qsizetype i = index; !stop.load(std::memory_order_relaxed); ++i) {
+            // Every aggregate holds a QObject and a QTimer component.
+            if (query<QTimer>(objects.at(i % objects.size())))
+                ++found;
+            ++count;
+        }
+        Q_UNUSED(found)
+        queries += count;
+    };
+
+    auto writer = [&] {
+        QObject component;
+        while (!stop.load(std::memory_order_relaxed)) {
+            writerTarget->add(&component);
+            writerTarget->remove(&component);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readerCount; ++i)
+        threads.emplace_back(reader, i);
+    if (withWriter)
+        threads.emplace_back(writer);
+
+    QElapsedTimer timer;
+    timer.start();
+    QThread::msleep(durationMs);
+    stop = true;
+    for (std::thread &thread : threads)
+        thread.join();
+    return queries / (timer.nsecsElapsed() / 1e9);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QObjectList objects;
+    QList<Aggregate *> aggregates;
+    for (int i = 0; i < aggregateCount; ++i) {
+        auto aggregate = new Aggregate;
+        auto plain = new QObject;
+        aggregate->add(plain);
+        aggregate->add(new QTimer);
+        aggregates.append(aggregate);
+        objects.append(plain);
+    }
+
+    std::printf("%8s %20s %20s\n", "readers", "queries/s", "queries/s (writer)");
+    const int maxThreads = qMax(1, QThread::idealThreadCount());
+    QList<int> readerCounts;
+    for (int readers = 1; readers < maxThreads; readers *= 2)
+        readerCounts.append(readers);
+    readerCounts.append(maxThreads);
+    for (int readers : std::as_const(readerCounts)) {
+        const double plain = run(objects, readers, false, aggregates.first());
+        const double contended = run(objects, readers, true, aggregates.first());
+        std::printf("%8d %20.0f %20.0f\n", readers, plain, contended);
+    }
+
+    qDeleteAll(aggregates);
+    return 0;
+}
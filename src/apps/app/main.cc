@@ -4,6 +4,7 @@
 #include <extensionsystem/pluginmanager.h>
 #include <extensionsystem/pluginspec.h>
 #include <resource/resource.hpp>
+#include <solutions/tasking/concurrentcall.h>
 #include <utils/algorithm.h>
 #include <utils/appdata.hpp>
 #include <utils/appinfo.h>
@@ -11,9 +12,11 @@
 #include <utils/logasync.h>
 #include <utils/qtcsettings_p.h>
 #include <utils/singletonmanager.hpp>
+#include <utils/startuptimeline.hpp>
 #include <utils/utils.hpp>
 #include <widgets/waitwidget.h>
 
+#include <QEventLoop>
 #include <QMessageBox>
 #include <QNetworkProxyFactory>
 #include <QStyle>
@@ -69,12 +72,68 @@ void setAppInfo()
     Utils::Internal::setAppInfo(info);
 }
 
-void setQss()
+auto readQss() -> QString
 {
-    Utils::setQSS({":/qss/qss/common.css",
-                   ":/qss/qss/mainwidget.css",
-                   ":/qss/qss/sidebarbutton.css",
-                   ":/qss/qss/specific.css"});
+    Utils::StartupPhase phase("readQss");
+    return Utils::readQSS({":/qss/qss/common.css",
+                           ":/qss/qss/mainwidget.css",
+                           ":/qss/qss/sidebarbutton.css",
+                           ":/qss/qss/specific.css"});
+}
+
+auto readFonts() -> QList<Utils::FontFile>
+{
+    Utils::StartupPhase phase("readFonts");
+    return Utils::readFonts((Utils::appInfo().resources / "fonts").toUserOutput());
+}
+
+void prepareLanguage(Utils::LanguageManager *languageManager)
+{
+    Utils::StartupPhase phase("prepareLanguage");
+    languageManager->prepareLanguage();
+}
+
+// 启动时相互独立、以读文件为主的步骤，在工作线程中并行读取，读完后回到主线程应用；
+// 样式表和翻译都应用后调用 onAppearanceReady
+auto startupRecipe(const std::function<void()> &onAppearanceReady) -> Tasking::Group
+{
+    using namespace Tasking;
+
+    const auto onQssSetup = [](ConcurrentCall<QString> &task) {
+        task.setConcurrentCallData(&readQss);
+    };
+    const auto onQssDone = [](const ConcurrentCall<QString> &task) {
+        Utils::StartupPhase phase("setQss");
+        const auto qss = task.result();
+        if (!qss.isEmpty()) {
+            qApp->setStyleSheet(qss);
+        }
+    };
+
+    const auto onFontsSetup = [](ConcurrentCall<QList<Utils::FontFile>> &task) {
+        task.setConcurrentCallData(&readFonts);
+    };
+    const auto onFontsDone = [](const ConcurrentCall<QList<Utils::FontFile>> &task) {
+        Utils::StartupPhase phase("addFonts");
+        Utils::addApplicationFonts(task.result());
+    };
+
+    // 单例在主线程中创建，工作线程只使用它
+    auto *languageManager = LANGUAGE_MANAGER;
+    const auto onLanguageSetup = [languageManager](ConcurrentCall<void> &task) {
+        task.setConcurrentCallData(&prepareLanguage, languageManager);
+    };
+    const auto onLanguageDone = [languageManager] {
+        Utils::StartupPhase phase("loadLanguage");
+        languageManager->loadLanguage();
+    };
+
+    return Group{parallel,
+                 Group{parallel,
+                       ConcurrentCallTask<QString>(onQssSetup, onQssDone),
+                       ConcurrentCallTask<void>(onLanguageSetup, onLanguageDone),
+                       onGroupDone(onAppearanceReady)},
+                 ConcurrentCallTask<QList<Utils::FontFile>>(onFontsSetup, onFontsDone)};
 }
 
 class Restarter
@@ -112,6 +171,7 @@ private:
 
 auto main(int argc, char *argv[]) -> int
 {
+    Utils::StartupTimeline::startFromEnvironment();
     Restarter restarter(argc, argv);
 #if defined(Q_OS_WIN) && QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     if (!qEnvironmentVariableIsSet("QT_OPENGL")) {
@@ -122,7 +182,9 @@ auto main(int argc, char *argv[]) -> int
 #endif
     Utils::setHighDpiEnvironmentVariable();
     SharedTools::QtSingleApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    Utils::StartupTimeline::begin("QApplication");
     SharedTools::QtSingleApplication app(Utils::appName, argc, argv);
+    Utils::StartupTimeline::end("QApplication");
     if (app.isRunning()) {
         qWarning() << "This is already running";
         if (app.sendMessage("raise_window_noop", 5000)) {
@@ -150,41 +212,84 @@ auto main(int argc, char *argv[]) -> int
     setAppInfo();
     QDir::setCurrent(app.applicationDirPath());
 
+    Utils::StartupTimeline::begin("crashpad");
     Dump::Crashpad crashpad(Utils::crashPath().toStdString(),
                             app.applicationDirPath().toStdString(),
                             {},
                             true);
-
-    LANGUAGE_MANAGER->loadLanguage();
+    Utils::StartupTimeline::end("crashpad");
 
     auto *log = Utils::LogAsync::instance();
-    log->setLogPath(Utils::logPath());
-    log->setAutoDelFile(true);
-    log->setAutoDelFileDays(7);
-    log->setOrientation(Utils::LogAsync::Orientation::StandardAndFile);
-    log->setLogLevel(QtDebugMsg);
-    log->startWork();
-
-    initResource();
-    qInfo().noquote() << "\n\n" + Utils::systemInfo() + "\n\n";
+    {
+        Utils::StartupPhase phase("startLog");
+        log->setLogPath(Utils::logPath());
+        log->setAutoDelFile(true);
+        log->setAutoDelFileDays(7);
+        auto rotationPolicy = log->rotationPolicy();
+        rotationPolicy.compress = true;
+        log->setRotationPolicy(rotationPolicy);
+        log->setOrientation(Utils::LogAsync::Orientation::StandardAndFile);
+        log->setLogLevel(QtDebugMsg);
+        log->startWork();
+    }
+
+    {
+        Utils::StartupPhase phase("initResource");
+        initResource();
+    }
+    {
+        Utils::StartupPhase phase("systemInfo");
+        qInfo().noquote() << "\n\n" + Utils::systemInfo() + "\n\n";
+    }
     Utils::setPixmapCacheLimit();
-    Utils::loadFonts((Utils::appInfo().resources / "fonts").toUserOutput());
-    setQss();
 
     // Make sure we honor the system's proxy settings
     QNetworkProxyFactory::setUseSystemConfiguration(true);
 
-    // 等待界面
-    QScopedPointer<Widgets::WaitWidget> waitWidgetPtr(new Widgets::WaitWidget);
-    waitWidgetPtr->show();
-    app.processEvents();
+    // 样式表、字体和翻译在工作线程中读取，同时主线程扫描插件，
+    // 全部完成后才加载插件（创建主窗口）
+    QScopedPointer<Widgets::WaitWidget> waitWidgetPtr;
+    QEventLoop appearanceLoop;
+    bool appearanceReady = false;
+    Tasking::TaskTree startupTree(startupRecipe([&] {
+        appearanceReady = true;
+        appearanceLoop.quit();
+    }));
+    // 另外两步是主线程上的扫描插件和加载插件
+    const int progressMaximum = startupTree.progressMaximum() + 2;
+    int startupProgress = 0;
+    int mainThreadProgress = 0;
+    const auto updateProgress = [&] {
+        if (waitWidgetPtr) {
+            waitWidgetPtr->setProgress(startupProgress + mainThreadProgress, progressMaximum);
+        }
+    };
+    QObject::connect(&startupTree, &Tasking::TaskTree::progressValueChanged, [&](int value) {
+        startupProgress = value;
+        updateProgress();
+    });
+    startupTree.start();
 
+    Utils::StartupTimeline::begin("settings");
     auto *userSettings = new Utils::QtcSettings(Utils::configFilePath(), QSettings::IniFormat);
     auto *installSettings = new Utils::QtcSettings(QSettings::IniFormat,
                                                    QSettings::SystemScope,
                                                    QLatin1String(Utils::organzationName),
                                                    QLatin1String(Utils::appName));
     Utils::Internal::SettingsSetup::setupSettings(userSettings, installSettings);
+    Utils::StartupTimeline::end("settings");
+
+    // 等待界面在样式表和翻译就绪后才显示，避免先以默认样式绘制
+    if (!appearanceReady) {
+        Utils::StartupPhase phase("waitForAppearance");
+        appearanceLoop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+    Utils::StartupTimeline::begin("waitWidget");
+    waitWidgetPtr.reset(new Widgets::WaitWidget);
+    updateProgress();
+    waitWidgetPtr->show();
+    app.processEvents();
+    Utils::StartupTimeline::end("waitWidget");
 
     ExtensionSystem::PluginManager pluginManager;
     ExtensionSystem::PluginManager::setPluginIID(QLatin1String("Youth.Qt.plugin"));
@@ -193,7 +298,19 @@ auto main(int argc, char *argv[]) -> int
     // We need to install plugins before we scan for them.
     ExtensionSystem::PluginManager::installPluginsAfterRestart();
 
-    ExtensionSystem::PluginManager::setPluginPaths({Utils::appInfo().plugins});
+    {
+        Utils::StartupPhase phase("scanPlugins");
+        ExtensionSystem::PluginManager::setPluginPaths({Utils::appInfo().plugins});
+    }
+    ++mainThreadProgress;
+    updateProgress();
+
+    if (startupTree.isRunning()) {
+        Utils::StartupPhase phase("waitForStartupTasks");
+        QEventLoop loop;
+        QObject::connect(&startupTree, &Tasking::TaskTree::done, &loop, &QEventLoop::quit);
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
 
     auto *coreplugin = ExtensionSystem::PluginManager::specById(QLatin1String("CorePlugin"));
     if (!coreplugin) {
@@ -218,7 +335,15 @@ auto main(int argc, char *argv[]) -> int
     }
 
     ExtensionSystem::PluginManager::checkForProblematicPlugins();
-    ExtensionSystem::PluginManager::loadPlugins();
+    QObject::connect(&pluginManager, &ExtensionSystem::PluginManager::initializationDone, [] {
+        Utils::StartupTimeline::finish("initializationDone");
+    });
+    {
+        Utils::StartupPhase phase("loadPlugins");
+        ExtensionSystem::PluginManager::loadPlugins();
+    }
+    ++mainThreadProgress;
+    updateProgress();
     if (coreplugin->hasError()) {
         displayError(msgCoreLoadFailure(coreplugin->errorString()));
         return 1;
@@ -248,6 +373,7 @@ auto main(int argc, char *argv[]) -> int
         QApplication::setEffectEnabled(Qt::UI_AnimateMenu, false);
     }
 
+    Utils::StartupTimeline::mark("eventLoop");
     auto exitCode = restarter.restartOrExit(app.exec());
     log->stop();
     return exitCode;
@@ -2,5 +2,7 @@ TEMPLATE = subdirs
 CONFIG += ordered
 
 SUBDIRS += \
+    benchcompare \
     crashreport \
+    logdecoder \
     app
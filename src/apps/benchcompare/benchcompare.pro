@@ -0,0 +1,20 @@
+include(../../../qmake/PlatformLibraries.pri)
+
+QT       += core widgets core5compat concurrent network core-private
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+TARGET = BenchCompare
+
+LIBS += \
+    -l$$replaceLibName(utils)
+
+include(../../../qmake/VcpkgToolchain.pri)
+
+DESTDIR = $$RUNTIME_OUTPUT_DIRECTORY
+
+SOURCES += \
+    main.cc
@@ -0,0 +1,80 @@
+#include <utils/benchmarker.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <cstdio>
+
+auto main(int argc, char *argv[]) -> int
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("BenchCompare");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Compare two benchmark result files written via QTC_BENCHMARK_OUTPUT.\n"
+        "Exits with 1 if any test case regressed significantly.");
+    parser.addHelpOption();
+    QCommandLineOption thresholdOption({"t", "threshold"},
+                                       "Minimum slowdown in percent to report as a regression "
+                                       "(default 5).",
+                                       "percent",
+                                       "5");
+    QCommandLineOption allOption({"a", "all"}, "Print unchanged test cases as well.");
+    parser.addOption(thresholdOption);
+    parser.addOption(allOption);
+    parser.addPositionalArgument("baseline", "Baseline results (*.jsonl).");
+    parser.addPositionalArgument("current", "Current results (*.jsonl).");
+    parser.process(app);
+
+    const auto files = parser.positionalArguments();
+    if (files.size() != 2) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+    auto ok = false;
+    const auto threshold = parser.value(thresholdOption).toDouble(&ok) / 100.0;
+    if (!ok || threshold < 0) {
+        fprintf(stderr, "Invalid threshold: %s\n", qPrintable(parser.value(thresholdOption)));
+        return EXIT_FAILURE;
+    }
+
+    QList<Utils::Benchmarker::Comparison> comparisons;
+    QString errorString;
+    if (!Utils::Benchmarker::compareResultFiles(files.at(0),
+                                                files.at(1),
+                                                &comparisons,
+                                                threshold,
+                                                &errorString)) {
+        fprintf(stderr, "%s\n", qPrintable(errorString));
+        return EXIT_FAILURE;
+    }
+
+    int regressions = 0;
+    for (const auto &comparison : std::as_const(comparisons)) {
+        const auto status = comparison.regression    ? "REGRESSION"
+                            : !comparison.significant ? "~"
+                            : comparison.change < 0   ? "faster"
+                                                      : "slower";
+        if (comparison.regression) {
+            ++regressions;
+        } else if (!parser.isSet(allOption) && !comparison.significant) {
+            continue;
+        }
+        const auto name = comparison.testsuite + "::" + comparison.testcase
+                          + (comparison.tags.isEmpty() ? QString()
+                                                       : " {" + comparison.tags + '}');
+        printf("%-60s %12.3fms -> %12.3fms %+8.2f%% (n=%d/%d, t=%.2f) %s\n",
+               qPrintable(name),
+               comparison.baselineMedianNs / 1e6,
+               comparison.currentMedianNs / 1e6,
+               comparison.change * 100,
+               comparison.baselineCount,
+               comparison.currentCount,
+               comparison.tValue,
+               status);
+    }
+    printf("%lld test cases compared, %d regressions\n",
+           static_cast<long long>(comparisons.size()),
+           regressions);
+    return regressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
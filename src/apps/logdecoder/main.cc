@@ -0,0 +1,87 @@
+#include <utils/logrecord.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+
+#include <cstdio>
+
+static auto decodeFile(const QString &path, QFile &output) -> bool
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly)) {
+        fprintf(stderr,
+                "Cannot open the file: %s %s\n",
+                qPrintable(path),
+                qPrintable(input.errorString()));
+        return false;
+    }
+    if (!Utils::isBinaryLogFileHeader(input.read(Utils::binaryLogFileHeaderSize()))) {
+        fprintf(stderr, "Not a binary log file: %s\n", qPrintable(path));
+        return false;
+    }
+
+    QByteArray buffer;
+    qsizetype offset = 0;
+    while (!input.atEnd()) {
+        buffer.remove(0, offset);
+        offset = 0;
+        buffer.append(input.read(1024 * 1024));
+
+        Utils::LogRecord record;
+        qsizetype used = 0;
+        while ((used = Utils::decodeLogRecord(QByteArrayView(buffer).sliced(offset), &record)) > 0) {
+            output.write(Utils::formatLogRecord(record).toUtf8());
+            offset += used;
+        }
+    }
+    if (offset != buffer.size()) {
+        fprintf(stderr,
+                "%s: %lld trailing bytes could not be decoded\n",
+                qPrintable(path),
+                static_cast<long long>(buffer.size() - offset));
+    }
+    return true;
+}
+
+auto main(int argc, char *argv[]) -> int
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LogDecoder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render binary log files (*.blog) as text.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"},
+                                    "Write the text log to <file> instead of stdout.",
+                                    "file");
+    parser.addOption(outputOption);
+    parser.addPositionalArgument("files", "Binary log files to decode.", "<files...>");
+    parser.process(app);
+
+    const auto files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    QFile output;
+    auto opened = false;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    } else {
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!opened) {
+        fprintf(stderr, "Cannot open the output: %s\n", qPrintable(output.errorString()));
+        return EXIT_FAILURE;
+    }
+
+    auto result = EXIT_SUCCESS;
+    for (const auto &file : std::as_const(files)) {
+        if (!decodeFile(file, output)) {
+            result = EXIT_FAILURE;
+        }
+    }
+    return result;
+}
@@ -24,6 +24,8 @@ public:
 
     QPointer<QPushButton> buttonPtr;
     QPointer<QWidget> widgetPtr;
+    WidgetFactory widgetFactory;
+    bool releasableWhenIdle = false;
     Type type = Type::Main;
 };
 
@@ -49,11 +51,46 @@ auto CoreWidget::type() const -> Type
     return d_ptr->type;
 }
 
+auto CoreWidget::hasWidget() const -> bool
+{
+    return !d_ptr->widgetPtr.isNull() || d_ptr->widgetFactory;
+}
+
+auto CoreWidget::ensureWidget() -> QWidget *
+{
+    if (d_ptr->widgetPtr.isNull() && d_ptr->widgetFactory) {
+        d_ptr->widgetPtr = d_ptr->widgetFactory();
+    }
+    return d_ptr->widgetPtr.data();
+}
+
+auto CoreWidget::isReleasableWhenIdle() const -> bool
+{
+    return d_ptr->releasableWhenIdle && d_ptr->widgetFactory;
+}
+
+auto CoreWidget::releaseWidget() -> bool
+{
+    if (!d_ptr->widgetFactory || d_ptr->widgetPtr.isNull()) {
+        return false;
+    }
+    // 页面可能正处于自身的事件处理中
+    d_ptr->widgetPtr->deleteLater();
+    d_ptr->widgetPtr.clear();
+    return true;
+}
+
 void CoreWidget::setWidget(QWidget *widget)
 {
     d_ptr->widgetPtr = widget;
 }
 
+void CoreWidget::setWidgetFactory(WidgetFactory factory, bool releasableWhenIdle)
+{
+    d_ptr->widgetFactory = std::move(factory);
+    d_ptr->releasableWhenIdle = releasableWhenIdle;
+}
+
 void CoreWidget::setButton(QPushButton *button, Type type)
 {
     d_ptr->type = type;
@@ -5,6 +5,8 @@
 #include <QList>
 #include <QObject>
 
+#include <functional>
+
 class QPushButton;
 class QWidget;
 
@@ -15,16 +17,30 @@ class CORE_EXPORT CoreWidget : public QObject
     Q_OBJECT
 public:
     enum Type : int { Main, Help };
+    using WidgetFactory = std::function<QWidget *()>;
 
     explicit CoreWidget(QObject *parent = nullptr);
     ~CoreWidget() override;
 
     [[nodiscard]] auto button() const -> QPushButton *;
+    // 页面尚未创建（或已被释放）时返回 nullptr
     [[nodiscard]] auto widget() const -> QWidget *;
     [[nodiscard]] auto type() const -> Type;
 
+    // 是否有页面可显示：已设置页面或页面工厂
+    [[nodiscard]] auto hasWidget() const -> bool;
+    // 返回页面，首次调用时通过工厂创建
+    auto ensureWidget() -> QWidget *;
+
+    // 空闲时是否允许释放页面，只对通过工厂创建的页面生效
+    [[nodiscard]] auto isReleasableWhenIdle() const -> bool;
+    // 释放由工厂创建的页面，下次 ensureWidget() 时重新创建
+    auto releaseWidget() -> bool;
+
 protected:
     void setWidget(QWidget *widget);
+    // 延迟创建页面：启动时只创建按钮，页面在第一次激活时创建
+    void setWidgetFactory(WidgetFactory factory, bool releasableWhenIdle = false);
     void setButton(QPushButton *button, Type type);
 
 private:
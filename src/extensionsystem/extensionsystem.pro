@@ -1,6 +1,6 @@
 include(../../qmake/PlatformLibraries.pri)
 
-QT += widgets core5compat network
+QT += widgets core5compat concurrent network
 
 DEFINES += EXTENSIONSYSTEM_LIBRARY
 TARGET = $$add_shared_library(extensionsystem)
@@ -25,6 +25,7 @@ HEADERS += \
     pluginmanager.h \
     pluginmanager_p.h \
     pluginspec.h \
+    pluginspeccache.h \
     pluginview.h
 
 SOURCES += \
@@ -36,6 +37,7 @@ SOURCES += \
     pluginerrorview.cpp \
     pluginmanager.cpp \
     pluginspec.cpp \
+    pluginspeccache.cpp \
     pluginview.cpp
 
 INCLUDEPATH += $$PWD/../utils
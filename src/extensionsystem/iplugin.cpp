@@ -76,11 +76,12 @@
 
     The plugins' \c delayedInitialize() functions are called after the
     application is already running, with a few milliseconds delay to
-    application startup, and between individual \c delayedInitialize()
-    function calls. To avoid unnecessary delays, a plugin should return
+    application startup. They are called in time slices (see
+    PluginManager::setDelayedInitializeBudget()), and control returns to the
+    event loop between slices. To avoid unnecessary delays, a plugin should return
     \c true from the function if it actually implements it, to indicate
-    that the next plugins' \c delayedInitialize() call should be delayed
-    a few milliseconds to give input and paint events a chance to be processed.
+    that the current slice should end, giving input and paint events a chance
+    to be processed before the next plugins' \c delayedInitialize() call.
 
     This function can be used if a plugin needs to do non-trivial setup that doesn't
     necessarily need to be done directly at startup, but still should be done within a
@@ -21,6 +21,8 @@ const char *OptionsParser::NOTEST_OPTION = "-notest";
 const char *OptionsParser::SCENARIO_OPTION = "-scenario";
 const char *OptionsParser::PROFILE_OPTION = "-profile";
 const char *OptionsParser::TRACE_OPTION = "-trace";
+const char *OptionsParser::PARALLEL_LOAD_OPTION = "-parallel-load";
+const char *OptionsParser::DELAYED_INIT_BUDGET_OPTION = "-delayed-init-budget";
 const char *OptionsParser::NO_CRASHCHECK_OPTION = "-no-crashcheck";
 
 OptionsParser::OptionsParser(const QStringList &args,
@@ -57,6 +59,10 @@ Result<> OptionsParser::parse()
             continue;
         if (checkForTraceOption())
             continue;
+        if (checkForParallelLoadOption())
+            continue;
+        if (checkForDelayedInitBudgetOption())
+            continue;
         if (checkForNoCrashcheckOption())
             continue;
 #ifdef EXTENSIONSYSTEM_WITH_TESTOPTION
@@ -238,6 +244,29 @@ bool OptionsParser::checkForTraceOption()
     return true;
 }
 
+bool OptionsParser::checkForParallelLoadOption()
+{
+    if (m_currentArg != QLatin1String(PARALLEL_LOAD_OPTION))
+        return false;
+    m_pmPrivate->m_parallelLoading = true;
+    return true;
+}
+
+bool OptionsParser::checkForDelayedInitBudgetOption()
+{
+    if (m_currentArg != QLatin1String(DELAYED_INIT_BUDGET_OPTION))
+        return false;
+    if (nextToken(RequiredToken)) {
+        bool ok = false;
+        const int budget = m_currentArg.toInt(&ok);
+        if (ok && budget > 0)
+            m_pmPrivate->m_delayedInitializeBudget = std::chrono::milliseconds(budget);
+        else
+            m_result = ResultError(Tr::tr("Invalid delayed initialization budget \"%1\".").arg(m_currentArg));
+    }
+    return true;
+}
+
 bool OptionsParser::checkForNoCrashcheckOption()
 {
     if (m_currentArg != QLatin1String(NO_CRASHCHECK_OPTION))
@@ -29,6 +29,8 @@ public:
     static const char *SCENARIO_OPTION;
     static const char *PROFILE_OPTION;
     static const char *TRACE_OPTION;
+    static const char *PARALLEL_LOAD_OPTION;
+    static const char *DELAYED_INIT_BUDGET_OPTION;
     static const char *NO_CRASHCHECK_OPTION;
 
 private:
@@ -43,6 +45,8 @@ private:
     bool checkForPluginOption();
     bool checkForProfilingOption();
     bool checkForTraceOption();
+    bool checkForParallelLoadOption();
+    bool checkForDelayedInitBudgetOption();
     bool checkForNoCrashcheckOption();
     bool checkForUnknownOption();
     void forceDisableAllPluginsExceptTestedAndForceEnabled();
@@ -8,6 +8,7 @@
 #include "optionsparser.h"
 #include "pluginmanager_p.h"
 #include "pluginspec.h"
+#include "pluginspeccache.h"
 
 #include <utils/algorithm.h>
 #include <utils/benchmarker.h>
@@ -19,6 +20,7 @@
 #include <utils/qtcprocess.h>
 #include <utils/qtcsettings.h>
 #include <utils/shutdownguard.h>
+#include <utils/startuptimeline.hpp>
 #include <utils/stringutils.h>
 #include <utils/threadutils.h>
 
@@ -39,17 +41,20 @@
 #include <QScopeGuard>
 #include <QSysInfo>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QWriteLocker>
+#include <QtConcurrent/QtConcurrentMap>
 
 #ifdef EXTENSIONSYSTEM_WITH_TESTOPTION
 #include <utils/hostosinfo.h>
 #include <QTest>
-#include <QThread>
 #endif
 
 #include <functional>
 #include <memory>
+#include <queue>
 #include <type_traits>
 
 Q_LOGGING_CATEGORY(pluginLog, "qtc.extensionsystem", QtWarningMsg)
@@ -313,6 +318,34 @@ QObjectList PluginManager::allObjects()
     return d->allObjects;
 }
 
+/*!
+    \internal
+
+    Returns the objects in the pool that inherit \a metaObject, without
+    taking listLock(). The returned list shares its data with the index.
+*/
+QObjectList PluginManager::objectsOfClass(const QMetaObject *metaObject)
+{
+    return d->objectIndex()->byClass.value(metaObject);
+}
+
+/*!
+    \internal
+
+    Returns the objects in the pool that implement the interface \a iid. The
+    first lookup of an interface scans the pool once.
+*/
+QObjectList PluginManager::objectsOfInterface(const char *iid)
+{
+    {
+        const auto index = d->objectIndex();
+        const auto it = index->byInterface.constFind(QByteArray::fromRawData(iid, qstrlen(iid)));
+        if (it != index->byInterface.cend())
+            return *it;
+    }
+    return d->indexInterface(iid);
+}
+
 /*!
     \internal
 */
@@ -780,7 +813,19 @@ void PluginManager::formatOptions(QTextStream &str,
     formatOption(str,
                  QLatin1String(OptionsParser::TRACE_OPTION),
                  QLatin1String("file"),
-                 QLatin1String("Write trace file (CTF) for plugin loading"),
+                 QLatin1String("Write Chrome trace-event file (JSON) for plugin loading"),
+                 optionIndentation,
+                 descriptionIndentation);
+    formatOption(str,
+                 QLatin1String(OptionsParser::PARALLEL_LOAD_OPTION),
+                 QString(),
+                 QLatin1String("Load plugin libraries of a dependency level in parallel"),
+                 optionIndentation,
+                 descriptionIndentation);
+    formatOption(str,
+                 QLatin1String(OptionsParser::DELAYED_INIT_BUDGET_OPTION),
+                 QLatin1String("ms"),
+                 QLatin1String("Time slice for delayed plugin initialization (default 10)"),
                  optionIndentation,
                  descriptionIndentation);
     formatOption(str,
@@ -977,24 +1022,101 @@ PluginSpecs PluginManager::loadQueue()
 
 //============PluginManagerPrivate===========
 
+/*!
+    \internal
+
+    Calls delayedInitialize() of queued plugins until the slice budget is used
+    up or a plugin asks for a delay. At least one plugin runs per slice.
+    Returns whether plugins are left for another slice.
+*/
+bool PluginManagerPrivate::runDelayedInitializeSlice()
+{
+    const qint64 budgetNS = std::chrono::nanoseconds(m_delayedInitializeBudget).count();
+    const qint64 sliceStartNS = m_profileTimer ? m_profileTimer->nsecsElapsed() : 0;
+    QElapsedTimer slice;
+    slice.start();
+    PluginSpec *last = nullptr;
+    while (!delayedInitializeQueue.empty()) {
+        PluginSpec *spec = delayedInitializeQueue.front();
+        delayedInitializeQueue.pop_front();
+        last = spec;
+        profilingReport(">delayedInitialize", spec);
+        const bool delay = spec->delayedInitialize();
+        profilingReport("<delayedInitialize", spec, &spec->performanceData().delayedInitialize);
+        // give UI a bit of breathing space
+        if (delay || slice.nsecsElapsed() >= budgetNS)
+            break;
+    }
+    ++m_delayedInitializeSlices;
+
+    const qint64 elapsedNS = slice.nsecsElapsed();
+    if (elapsedNS > budgetNS) {
+        ++m_delayedInitializeOverruns;
+        if (m_profilingVerbosity > 0) {
+            qDebug("%-22s %-40s %8lldms over budget (%lldms > %lldms)",
+                   "!delayedInitialize",
+                   last ? qPrintable(last->id()) : "",
+                   m_profileTimer ? m_profileTimer->elapsed() : 0,
+                   elapsedNS / 1000000,
+                   qint64(m_delayedInitializeBudget.count()));
+        }
+        if (m_traceWriter && m_profileTimer) {
+            m_traceWriter->begin("slice overrun", "delayedInitialize", sliceStartNS);
+            m_traceWriter->end("slice overrun",
+                               "delayedInitialize",
+                               sliceStartNS + elapsedNS,
+                               {{"plugin", last ? last->id() : QString()},
+                                {"budgetMs", qint64(m_delayedInitializeBudget.count())}});
+        }
+    }
+    return !delayedInitializeQueue.empty();
+}
+
+/*!
+    \internal
+
+    Moves \a spec to the front of the delayed initialization queue, preceded
+    by the queued plugins that depend on it, so that the order guaranteed by
+    IPlugin::delayedInitialize() is kept.
+*/
+void PluginManagerPrivate::prioritizeDelayedInitialize(PluginSpec *spec)
+{
+    if (std::find(delayedInitializeQueue.cbegin(), delayedInitializeQueue.cend(), spec)
+        == delayedInitializeQueue.cend()) {
+        return;
+    }
+    QSet<PluginSpec *> dependents = PluginManager::pluginsRequiringPlugin(spec);
+    dependents.insert(spec);
+    std::stable_partition(delayedInitializeQueue.begin(),
+                          delayedInitializeQueue.end(),
+                          [&dependents](PluginSpec *queued) { return dependents.contains(queued); });
+}
+
 void PluginManagerPrivate::startDelayedInitialize()
 {
-    Utils::setMimeStartupPhase(MimeStartupPhase::PluginsDelayedInitializing);
+    if (m_delayedInitializeSlices == 0)
+        Utils::setMimeStartupPhase(MimeStartupPhase::PluginsDelayedInitializing);
+    if (runDelayedInitializeSlice()) {
+        // Yield to the event loop, then continue with the next slice.
+        delayedInitializeTimer.setInterval(0);
+        delayedInitializeTimer.start();
+        return;
+    }
     {
-        while (!delayedInitializeQueue.empty()) {
-            PluginSpec *spec = delayedInitializeQueue.front();
-            const std::string specName = spec->id().toStdString();
-            delayedInitializeQueue.pop();
-            profilingReport(">delayedInitialize", spec);
-            bool delay = spec->delayedInitialize();
-            profilingReport("<delayedInitialize", spec, &spec->performanceData().delayedInitialize);
-            if (delay) // give UI a bit of breathing space, but prevent user interaction
-                QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-        }
         Utils::setMimeStartupPhase(MimeStartupPhase::UpAndRunning);
         m_isInitializationDone = true;
         if (m_profileTimer)
             m_totalStartupMS = m_profileTimer->elapsed();
+        if (m_traceWriter) {
+            m_traceWriter->instant("initializationDone", m_profileTimer->nsecsElapsed());
+            m_traceWriter->flush();
+        }
+        if (m_profilingVerbosity > 0) {
+            qDebug("delayedInitialize: %d slices, %d over the %lldms budget",
+                   m_delayedInitializeSlices,
+                   m_delayedInitializeOverruns,
+                   qint64(m_delayedInitializeBudget.count()));
+        }
         printProfilingSummary();
     }
     emit q->initializationDone();
@@ -1385,6 +1507,8 @@ void PluginManagerPrivate::addObject(QObject *obj)
         }
 
         allObjects.append(obj);
+        indexObject(obj);
+        traceObjectCount();
     }
     emit q->objectAdded(obj);
 }
@@ -1410,6 +1534,97 @@ void PluginManagerPrivate::removeObject(QObject *obj)
     emit q->aboutToRemoveObject(obj);
     QWriteLocker lock(&m_lock);
     allObjects.removeAll(obj);
+    unindexObject(obj);
+    traceObjectCount();
+}
+
+/*!
+    \internal
+*/
+std::shared_ptr<const PluginManagerPrivate::ObjectIndex> PluginManagerPrivate::objectIndex() const
+{
+    QMutexLocker locker(&m_objectIndexPointerMutex);
+    return m_objectIndex;
+}
+
+/*!
+    \internal
+*/
+void PluginManagerPrivate::publishObjectIndex(std::shared_ptr<const ObjectIndex> index)
+{
+    QMutexLocker locker(&m_objectIndexPointerMutex);
+    m_objectIndex.swap(index);
+    // The old snapshot is released after unlocking, outside the critical section.
+}
+
+/*!
+    \internal
+
+    Publishes a copy of the object index that contains \a obj. The copy is
+    shallow: only the lists \a obj is added to are detached.
+*/
+void PluginManagerPrivate::indexObject(QObject *obj)
+{
+    QMutexLocker locker(&m_objectIndexMutex);
+    auto index = std::make_shared<ObjectIndex>(*objectIndex());
+    const QMetaObject *metaObject = obj->metaObject();
+    index->classOf.insert(obj, metaObject);
+    for (const QMetaObject *mo = metaObject; mo; mo = mo->superClass())
+        index->byClass[mo].append(obj);
+    // Same test as qobject_cast<Interface *>(), with nothing kept from the caller's library.
+    for (auto it = index->byInterface.begin(); it != index->byInterface.end(); ++it) {
+        if (obj->qt_metacast(it.key().constData()))
+            it->append(obj);
+    }
+    publishObjectIndex(std::move(index));
+}
+
+/*!
+    \internal
+*/
+void PluginManagerPrivate::unindexObject(QObject *obj)
+{
+    QMutexLocker locker(&m_objectIndexMutex);
+    auto index = std::make_shared<ObjectIndex>(*objectIndex());
+    const QMetaObject *metaObject = index->classOf.take(obj);
+    for (const QMetaObject *mo = metaObject; mo; mo = mo->superClass()) {
+        const auto it = index->byClass.find(mo);
+        if (it == index->byClass.end())
+            continue;
+        it->removeOne(obj);
+        if (it->isEmpty())
+            index->byClass.erase(it);
+    }
+    // Empty interface lists are kept, they record that the interface is indexed.
+    for (auto it = index->byInterface.begin(); it != index->byInterface.end(); ++it)
+        it->removeOne(obj);
+    publishObjectIndex(std::move(index));
+}
+
+/*!
+    \internal
+
+    Starts indexing the interface \a iid, so that objects added later are
+    tested for it as well, and returns the objects that implement it.
+*/
+QObjectList PluginManagerPrivate::indexInterface(const char *iid)
+{
+    QMutexLocker locker(&m_objectIndexMutex);
+    const QByteArray key(iid);
+    const std::shared_ptr<const ObjectIndex> current = objectIndex();
+    if (const auto it = current->byInterface.constFind(key); it != current->byInterface.cend())
+        return *it; // Indexed by another thread in the meantime.
+
+    // Every object in the pool is a QObject.
+    QObjectList objects;
+    for (QObject *obj : current->byClass.value(&QObject::staticMetaObject)) {
+        if (obj->qt_metacast(iid))
+            objects.append(obj);
+    }
+    auto index = std::make_shared<ObjectIndex>(*current);
+    index->byInterface.insert(key, objects);
+    publishObjectIndex(std::move(index));
+    return objects;
 }
 
 /*!
@@ -1423,6 +1638,8 @@ void PluginManagerPrivate::loadPlugins()
     const PluginSpecs queue = loadQueue();
     Utils::setMimeStartupPhase(MimeStartupPhase::PluginsLoading);
     {
+        if (m_parallelLoading)
+            preloadLibraries(queue);
         for (PluginSpec *spec : queue)
             loadPlugin(spec, PluginSpec::Loaded);
     }
@@ -1441,7 +1658,7 @@ void PluginManagerPrivate::loadPlugins()
         Utils::reverseForeach(queue, [this](PluginSpec *spec) {
             loadPlugin(spec, PluginSpec::Running);
             if (spec->state() == PluginSpec::Running) {
-                delayedInitializeQueue.push(spec);
+                delayedInitializeQueue.push_back(spec);
             } else {
                 // Plugin initialization failed, so cleanup after it
                 spec->kill();
@@ -1459,6 +1676,63 @@ void PluginManagerPrivate::loadPlugins()
     delayedInitializeTimer.start();
 }
 
+/*!
+    \internal
+    Loads the libraries of \a queue on a thread pool, one dependency level at a
+    time. The following loadPlugin(spec, PluginSpec::Loaded) then only creates the
+    plugin instance on the main thread.
+*/
+void PluginManagerPrivate::preloadLibraries(const PluginSpecs &queue)
+{
+    // The queue is in dependency order, so every dependency has its level already.
+    QHash<const PluginSpec *, int> levelOfSpec;
+    QList<PluginSpecs> levels;
+    for (PluginSpec *spec : queue) {
+        int level = 0;
+        const QHash<PluginDependency, PluginSpec *> deps = spec->dependencySpecs();
+        for (auto it = deps.cbegin(), end = deps.cend(); it != end; ++it)
+            level = std::max(level, levelOfSpec.value(it.value(), -1) + 1);
+        levelOfSpec.insert(spec, level);
+
+        // Plugins that still need the user to accept their terms must not be loaded yet.
+        const bool canPreload = !spec->hasError() && spec->state() == PluginSpec::Resolved
+                                && spec->isEffectivelyEnabled()
+                                && (!spec->termsAndConditions()
+                                    || pluginsWithAcceptedTermsAndConditions.contains(spec->id()));
+        if (!canPreload)
+            continue;
+        if (levels.size() <= level)
+            levels.resize(level + 1);
+        levels[level].append(spec);
+    }
+
+    QThreadPool pool;
+    for (PluginSpecs &level : levels) {
+        QtConcurrent::blockingMap(&pool, level, [this](PluginSpec *spec) {
+            const QString phase("preloadLibrary");
+            const QString name = phase + ' ' + spec->id();
+            QElapsedTimer timer;
+            timer.start();
+            if (m_traceWriter)
+                m_traceWriter->begin(name, phase, m_profileTimer->nsecsElapsed());
+            spec->preloadLibrary();
+            const qint64 elapsedNS = timer.nsecsElapsed();
+            spec->performanceData().preload = elapsedNS / 1000000;
+            if (m_traceWriter) {
+                m_traceWriter->end(name,
+                                   phase,
+                                   m_profileTimer->nsecsElapsed(),
+                                   {{"plugin", spec->id()}, {"phase", phase}});
+            }
+            if (m_profileTimer) {
+                Utils::Benchmarker::reportNs("loadPlugins",
+                                             spec->id() + "_preloadLibrary",
+                                             {elapsedNS});
+            }
+        });
+    }
+}
+
 void PluginManagerPrivate::loadPluginsAtRuntime(const QSet<PluginSpec *> &plugins)
 {
     const bool allSoftloadable = allOf(plugins, &PluginSpec::isEffectivelySoftloadable);
@@ -1539,27 +1813,32 @@ void PluginManagerPrivate::shutdown()
 */
 const PluginSpecs PluginManagerPrivate::loadQueue()
 {
-    PluginSpecs queue;
+    LoadQueueState state;
+    state.queue.reserve(pluginSpecs.size());
     for (PluginSpec *spec : std::as_const(pluginSpecs)) {
-        PluginSpecs circularityCheckQueue;
-        loadQueue(spec, queue, circularityCheckQueue);
+        state.circularityCheckQueue.clear();
+        state.circularityCheck.clear();
+        loadQueue(spec, state);
     }
-    return queue;
+    return state.queue;
 }
 
 /*!
     \internal
+
+    Depth-first topological sort over the resolved dependencies. The sets make
+    the membership tests constant time, so one pass is linear in the number of
+    plugins and dependencies.
 */
-bool PluginManagerPrivate::loadQueue(PluginSpec *spec,
-                                     PluginSpecs &queue,
-                                     PluginSpecs &circularityCheckQueue)
+bool PluginManagerPrivate::loadQueue(PluginSpec *spec, LoadQueueState &state)
 {
-    if (queue.contains(spec))
+    if (state.queued.contains(spec))
         return true;
     // check for circular dependencies
-    if (circularityCheckQueue.contains(spec)) {
+    if (state.circularityCheck.contains(spec)) {
         QString errorString = Tr::tr("Circular dependency detected:");
         errorString += QLatin1Char('\n');
+        const PluginSpecs &circularityCheckQueue = state.circularityCheckQueue;
         int index = circularityCheckQueue.indexOf(spec);
         for (int i = index; i < circularityCheckQueue.size(); ++i) {
             const PluginSpec *depSpec = circularityCheckQueue.at(i);
@@ -1571,10 +1850,12 @@ bool PluginManagerPrivate::loadQueue(PluginSpec *spec,
         spec->setError(errorString);
         return false;
     }
-    circularityCheckQueue.append(spec);
+    state.circularityCheckQueue.append(spec);
+    state.circularityCheck.insert(spec);
     // check if we have the dependencies
     if (spec->state() == PluginSpec::Invalid || spec->state() == PluginSpec::Read) {
-        queue.append(spec);
+        state.queue.append(spec);
+        state.queued.insert(spec);
         return false;
     }
 
@@ -1586,7 +1867,7 @@ bool PluginManagerPrivate::loadQueue(PluginSpec *spec,
         if (it.key().type == PluginDependency::Test)
             continue;
         PluginSpec *depSpec = it.value();
-        if (!loadQueue(depSpec, queue, circularityCheckQueue)) {
+        if (!loadQueue(depSpec, state)) {
             spec->setError(
                 Tr::tr("Cannot load plugin because dependency failed to load: %1 (%2)\nReason: %3")
                     .arg(depSpec->name(), depSpec->version(), depSpec->errorString()));
@@ -1594,7 +1875,8 @@ bool PluginManagerPrivate::loadQueue(PluginSpec *spec,
         }
     }
     // add self
-    queue.append(spec);
+    state.queue.append(spec);
+    state.queued.insert(spec);
     return true;
 }
 
@@ -1716,7 +1998,7 @@ PluginSpec *PluginManager::specById(const QString &id)
 
 bool PluginManager::specExists(const QString &id)
 {
-    return Utils::anyOf(d->pluginSpecs, Utils::equal(&PluginSpec::id, id));
+    return d->m_pluginsById.contains(id);
 }
 
 bool PluginManager::specExistsAndIsEnabled(const QString &id)
@@ -1913,18 +2195,36 @@ void PluginManagerPrivate::setPluginPaths(const FilePaths &paths)
     readPluginPaths();
 }
 
-static const FilePaths pluginFiles(const FilePaths &pluginPaths)
+struct PluginDirectoryEntries
+{
+    FilePaths libraries;
+    FilePaths subDirectories;
+};
+
+static const FilePaths pluginFiles(const FilePaths &pluginPaths, QThreadPool *pool)
 {
     FilePaths pluginFiles;
     FilePaths searchPaths = pluginPaths;
+    // Breadth-first, one level at a time. The directories of a level are listed in parallel
+    // and merged in order, which gives the same result as a sequential walk.
     while (!searchPaths.isEmpty()) {
-        const FilePath dir = searchPaths.takeFirst().absoluteFilePath();
-        const FilePaths files = dir.dirEntries(QDir::Files | QDir::NoSymLinks);
-        pluginFiles += Utils::filtered(files, [](const FilePath &path) {
-            return QLibrary::isLibrary(path.toFSPathString());
-        });
-        const FilePaths dirs = dir.dirEntries(QDir::Dirs | QDir::NoDotAndDotDot);
-        searchPaths += dirs;
+        const QList<PluginDirectoryEntries> level
+            = QtConcurrent::blockingMapped<QList<PluginDirectoryEntries>>(
+                pool, searchPaths, [](const FilePath &path) {
+                    const FilePath dir = path.absoluteFilePath();
+                    PluginDirectoryEntries entries;
+                    const FilePaths files = dir.dirEntries(QDir::Files | QDir::NoSymLinks);
+                    entries.libraries = Utils::filtered(files, [](const FilePath &path) {
+                        return QLibrary::isLibrary(path.toFSPathString());
+                    });
+                    entries.subDirectories = dir.dirEntries(QDir::Dirs | QDir::NoDotAndDotDot);
+                    return entries;
+                });
+        searchPaths.clear();
+        for (const PluginDirectoryEntries &entries : level) {
+            pluginFiles += entries.libraries;
+            searchPaths += entries.subDirectories;
+        }
     }
     return pluginFiles;
 }
@@ -1932,6 +2232,7 @@ static const FilePaths pluginFiles(const FilePaths &pluginPaths)
 void PluginManagerPrivate::addPlugins(const PluginSpecs &specs)
 {
     pluginSpecs += specs;
+    indexPlugins(specs);
 
     for (PluginSpec *spec : specs) {
         // defaultDisabledPlugins and defaultEnabledPlugins from install settings
@@ -2089,18 +2390,63 @@ void PluginManagerPrivate::readPluginPaths()
 {
     PluginSpecs newSpecs;
 
-    // from the file system
-    for (const FilePath &pluginFile : pluginFiles(pluginPaths)) {
+    // from the file system, skipping the library scan for plugins that did not change.
+    // Discovery and meta data parsing are mostly waiting for I/O, so they fan out over
+    // more threads than there are cores.
+    QThreadPool pool;
+    pool.setMaxThreadCount(4 * QThread::idealThreadCount());
+    PluginSpecCache cache(pluginIID);
+
+    struct ScannedPlugin
+    {
+        PluginSpecCache::FileStamp stamp;
+        PluginSpecCache::Entry entry;
+        PluginSpec *spec = nullptr;
+    };
+    const auto scanPlugin = [&cache](const FilePath &pluginFile) {
+        ScannedPlugin result;
+        result.stamp = PluginSpecCache::fileStamp(pluginFile);
+        if (const std::optional<PluginSpecCache::Entry> entry = cache.find(pluginFile, result.stamp)) {
+            result.entry = *entry;
+            if (entry->error.isEmpty()) {
+                Result<std::unique_ptr<PluginSpec>> spec = readCppPluginSpec(pluginFile,
+                                                                             entry->metaData);
+                if (spec)
+                    result.spec = spec->release();
+                else
+                    result.entry.error = spec.error();
+            }
+            return result;
+        }
         Result<std::unique_ptr<PluginSpec>> spec = readCppPluginSpec(pluginFile);
-        if (!spec) {
+        if (spec) {
+            result.entry.metaData = static_cast<CppPluginSpec *>(spec->get())->d->loader->metaData();
+            result.spec = spec->release();
+        } else {
+            result.entry.error = spec.error();
+        }
+        return result;
+    };
+
+    const FilePaths files = pluginFiles(pluginPaths, &pool);
+    const QList<ScannedPlugin> scanned
+        = QtConcurrent::blockingMapped<QList<ScannedPlugin>>(&pool, files, scanPlugin);
+
+    // merge in discovery order
+    for (qsizetype i = 0; i < files.size(); ++i) {
+        const ScannedPlugin &plugin = scanned.at(i);
+        cache.insert(files.at(i), plugin.stamp, plugin.entry);
+        if (!plugin.spec) {
             qCInfo(pluginLog).noquote() << QString("Ignoring plugin \"%1\" because: %2")
-                                               .arg(pluginFile.toUserOutput())
-                                               .arg(spec.error());
+                                               .arg(files.at(i).toUserOutput())
+                                               .arg(plugin.entry.error);
             continue;
         }
-        newSpecs.append(spec->release());
+        newSpecs.append(plugin.spec);
     }
 
+    cache.save();
+
     // static
     for (const QStaticPlugin &plugin : QPluginLoader::staticPlugins()) {
         Result<std::unique_ptr<PluginSpec>> spec = readCppPluginSpec(plugin);
@@ -2122,10 +2468,53 @@ void PluginManagerPrivate::readPluginPaths()
     addPlugins(newSpecs);
 }
 
+/*!
+    \internal
+
+    Adds \a specs to the id and option indexes.
+*/
+void PluginManagerPrivate::indexPlugins(const PluginSpecs &specs)
+{
+    for (PluginSpec *spec : specs) {
+        m_pluginsById[spec->id()].append(spec);
+        // Like a scan of the sorted pluginSpecs, the first id wins.
+        for (const PluginArgumentDescription &argument : spec->argumentDescriptions()) {
+            PluginSpec *&owner = m_pluginsByOption[argument.name];
+            if (!owner || spec->id() < owner->id())
+                owner = spec;
+        }
+    }
+}
+
+/*!
+    \internal
+
+    Returns the plugins that can satisfy a dependency or recommendation of
+    \a spec: the plugins for each dependency in the order of dependencies(),
+    followed by the plugins for each id in recommends(). Plugins with the same
+    id keep the order in which they were indexed. Ids are looked up in lower
+    case, like in pluginById().
+*/
+PluginSpecs PluginManagerPrivate::dependencyCandidates(const PluginSpec *spec) const
+{
+    PluginSpecs candidates;
+    const QList<PluginDependency> dependencies = spec->dependencies();
+    for (const PluginDependency &dependency : dependencies)
+        candidates += m_pluginsById.value(dependency.id.toLower());
+    const QStringList recommends = spec->recommends();
+    for (const QString &recommendedId : recommends)
+        candidates += m_pluginsById.value(recommendedId.toLower());
+    return candidates;
+}
+
 void PluginManagerPrivate::resolveDependencies()
 {
-    for (PluginSpec *spec : std::as_const(pluginSpecs))
-        spec->resolveDependencies(pluginSpecs);
+    // Only hand each spec the plugins matching its dependency ids instead of all plugins.
+    // Specs past Resolved keep their dependencies, so they are not looked at again.
+    for (PluginSpec *spec : std::as_const(pluginSpecs)) {
+        if (spec->state() <= PluginSpec::Resolved)
+            spec->resolveDependencies(dependencyCandidates(spec));
+    }
 }
 
 void PluginManagerPrivate::enableDependenciesIndirectly()
@@ -2133,9 +2522,11 @@ void PluginManagerPrivate::enableDependenciesIndirectly()
     for (PluginSpec *spec : std::as_const(pluginSpecs))
         spec->setEnabledIndirectly(false);
     // cannot use reverse loadQueue here, because test dependencies can introduce circles
+    // Each plugin enters the worklist at most once: only plugins that were not yet
+    // effectively enabled are returned by PluginSpec::enableDependenciesIndirectly().
     PluginSpecs queue = Utils::filtered(pluginSpecs, &PluginSpec::isEffectivelyEnabled);
-    while (!queue.isEmpty()) {
-        PluginSpec *spec = queue.takeFirst();
+    for (qsizetype i = 0; i < queue.size(); ++i) {
+        PluginSpec *spec = queue.at(i);
         queue += spec->enableDependenciesIndirectly(containsTestSpec(spec));
     }
 }
@@ -2146,18 +2537,14 @@ PluginSpec *PluginManagerPrivate::pluginForOption(const QString &option,
 {
     // Look in the plugins for an option
     *requiresArgument = false;
-    for (PluginSpec *spec : std::as_const(pluginSpecs)) {
-        PluginArgumentDescription match = Utils::findOrDefault(spec->argumentDescriptions(),
-                                                               [option](
-                                                                   PluginArgumentDescription pad) {
-                                                                   return pad.name == option;
-                                                               });
-        if (!match.name.isEmpty()) {
-            *requiresArgument = !match.parameter.isEmpty();
-            return spec;
-        }
-    }
-    return nullptr;
+    PluginSpec *spec = m_pluginsByOption.value(option);
+    if (!spec)
+        return nullptr;
+    const PluginArgumentDescription match = Utils::findOrDefault(
+        spec->argumentDescriptions(),
+        [option](const PluginArgumentDescription &pad) { return pad.name == option; });
+    *requiresArgument = !match.parameter.isEmpty();
+    return spec;
 }
 
 PluginSpec *PluginManagerPrivate::pluginById(const QString &id_in) const
@@ -2165,7 +2552,8 @@ PluginSpec *PluginManagerPrivate::pluginById(const QString &id_in) const
     QString id = id_in;
     // Plugin ids are always lower case. So the id argument should be too.
     QTC_ASSERT(id.isLower(), id = id.toLower());
-    return Utils::findOrDefault(pluginSpecs, Utils::equal(&PluginSpec::id, id));
+    const auto it = m_pluginsById.constFind(id);
+    return it == m_pluginsById.cend() ? nullptr : it->first();
 }
 
 void PluginManagerPrivate::increaseProfilingVerbosity()
@@ -2178,14 +2566,42 @@ void PluginManagerPrivate::increaseProfilingVerbosity()
 void PluginManagerPrivate::enableTracing(const QString &filePath)
 {
     const QString jsonFilePath = filePath.endsWith(".json") ? filePath : filePath + ".json";
+    m_traceWriter = std::make_shared<Utils::TraceWriter>(jsonFilePath);
+    if (!m_traceWriter->isOpen()) {
+        qWarning() << "Cannot open trace file" << jsonFilePath << m_traceWriter->errorString();
+        m_traceWriter.reset();
+        return;
+    }
+    if (!m_profileTimer)
+        PluginManager::startProfiling();
+}
+
+void PluginManagerPrivate::traceObjectCount()
+{
+    if (m_traceWriter && m_profileTimer)
+        m_traceWriter->counter("allObjects", m_profileTimer->nsecsElapsed(), allObjects.size());
 }
 
 void PluginManagerPrivate::profilingReport(const char *what, const PluginSpec *spec, qint64 *target)
 {
     if (m_profileTimer) {
-        const qint64 absoluteElapsedMS = m_profileTimer->elapsed();
-        const qint64 elapsedMS = absoluteElapsedMS - m_profileElapsedMS;
-        m_profileElapsedMS = absoluteElapsedMS;
+        const qint64 absoluteElapsedNS = m_profileTimer->nsecsElapsed();
+        const qint64 elapsedNS = absoluteElapsedNS - m_profileElapsedNS;
+        m_profileElapsedNS = absoluteElapsedNS;
+        if (m_traceWriter) {
+            const QString phase = QString::fromUtf8(what + 1);
+            const QString name = phase + ' ' + spec->id();
+            if (what[0] == '>') {
+                m_traceWriter->begin(name, phase, absoluteElapsedNS);
+            } else {
+                m_traceWriter->end(name,
+                                   phase,
+                                   absoluteElapsedNS,
+                                   {{"plugin", spec->id()}, {"phase", phase}});
+            }
+        }
+        const qint64 absoluteElapsedMS = absoluteElapsedNS / 1000000;
+        const qint64 elapsedMS = elapsedNS / 1000000;
         if (m_profilingVerbosity > 0) {
             qDebug("%-22s %-40s %8lldms (%8lldms)",
                    what,
@@ -2198,7 +2614,7 @@ void PluginManagerPrivate::profilingReport(const char *what, const PluginSpec *s
             *target = elapsedMS;
             tc = spec->id() + '_';
             tc += QString::fromUtf8(QByteArray(what + 1));
-            Utils::Benchmarker::report("loadPlugins", tc, elapsedMS);
+            Utils::Benchmarker::reportNs("loadPlugins", tc, {elapsedNS});
         }
     }
 }
@@ -2283,9 +2699,72 @@ QObject *PluginManager::getObjectByName(const QString &name)
 
 void PluginManager::startProfiling()
 {
-    d->m_profileTimer.reset(new QElapsedTimer);
-    d->m_profileTimer->start();
-    d->m_profileElapsedMS = 0;
+    // Continue the application's startup timeline if there is one, so that plugin
+    // loading shows up in the same trace and on the same clock.
+    if (StartupTimeline::isEnabled()) {
+        d->m_profileTimer.reset(new QElapsedTimer(StartupTimeline::clock()));
+        if (!d->m_traceWriter)
+            d->m_traceWriter = StartupTimeline::traceWriter();
+    } else {
+        d->m_profileTimer.reset(new QElapsedTimer);
+        d->m_profileTimer->start();
+    }
+    d->m_profileElapsedNS = d->m_profileTimer->nsecsElapsed();
+}
+
+/*!
+    Enables or disables parallel loading of plugin libraries. When enabled,
+    loadPlugins() groups the load queue into dependency levels and loads the
+    libraries of each level on a thread pool, which runs their static
+    initializers concurrently. Creating the plugin instances, initialize() and
+    extensionsInitialized() still happen in order on the main thread.
+
+    Crash detection (see \c -no-crashcheck) cannot attribute a crash during the
+    concurrent part to a single plugin.
+*/
+void PluginManager::setParallelLoadingEnabled(bool enabled)
+{
+    d->m_parallelLoading = enabled;
+}
+
+bool PluginManager::isParallelLoadingEnabled()
+{
+    return d->m_parallelLoading;
+}
+
+/*!
+    Sets the time budget of one delayed initialization slice to \a budget.
+
+    After the plugins are running, their delayedInitialize() functions are
+    called in slices. Between slices control returns to the event loop, so the
+    UI stays responsive while delayed initialization is in progress. A slice
+    ends when its budget is used up or a plugin returns \c true from
+    delayedInitialize(). Slices that take longer than the budget are reported
+    in the profiling output.
+
+    The default is 10 milliseconds.
+*/
+void PluginManager::setDelayedInitializeBudget(std::chrono::milliseconds budget)
+{
+    d->m_delayedInitializeBudget = std::max(budget, std::chrono::milliseconds(1));
+}
+
+std::chrono::milliseconds PluginManager::delayedInitializeBudget()
+{
+    return d->m_delayedInitializeBudget;
+}
+
+/*!
+    Runs the delayed initialization of \a spec before that of the other
+    pending plugins, for example because its UI was just shown. Plugins that
+    depend on \a spec are moved along, since their delayedInitialize()
+    functions are called first.
+
+    Does nothing if \a spec is not waiting for delayed initialization.
+*/
+void PluginManager::prioritizeDelayedInitialize(PluginSpec *spec)
+{
+    d->prioritizeDelayedInitialize(spec);
 }
 
 void PluginManager::setAcceptTermsAndConditionsCallback(
@@ -12,6 +12,9 @@
 #include <QObject>
 #include <QStringList>
 
+#include <chrono>
+#include <type_traits>
+
 QT_BEGIN_NAMESPACE
 class QTextStream;
 QT_END_NAMESPACE
@@ -41,33 +44,45 @@ public:
     static QReadWriteLock *listLock();
 
     // This is useful for soft dependencies using pure interfaces.
+    // The lookups go through a type index of the object pool and do not take listLock().
     template<typename T>
     static T *getObject()
     {
-        QReadLocker lock(listLock());
-        const QObjectList all = allObjects();
-        for (QObject *obj : all) {
-            if (T *result = qobject_cast<T *>(obj))
-                return result;
-        }
-        return nullptr;
+        const QObjectList objects = objectsOfType<T>();
+        return objects.isEmpty() ? nullptr : qobject_cast<T *>(objects.first());
     }
     template<typename T, typename Predicate>
     static T *getObject(Predicate predicate)
     {
-        QReadLocker lock(listLock());
-        const QObjectList all = allObjects();
-        for (QObject *obj : all) {
+        const QObjectList objects = objectsOfType<T>();
+        for (QObject *obj : objects) {
             if (T *result = qobject_cast<T *>(obj))
                 if (predicate(result))
                     return result;
         }
-        return 0;
+        return nullptr;
+    }
+    template<typename T>
+    static QList<T *> getObjects()
+    {
+        const QObjectList objects = objectsOfType<T>();
+        QList<T *> results;
+        results.reserve(objects.size());
+        for (QObject *obj : objects)
+            results.append(qobject_cast<T *>(obj));
+        return results;
     }
 
     static QObject *getObjectByName(const QString &name);
 
     static void startProfiling();
+    // Opt-in: map the libraries of each dependency level concurrently before the plugin
+    // instances are created, initialized and run in order on the main thread.
+    static void setParallelLoadingEnabled(bool enabled);
+    static bool isParallelLoadingEnabled();
+    static void setDelayedInitializeBudget(std::chrono::milliseconds budget);
+    static std::chrono::milliseconds delayedInitializeBudget();
+    static void prioritizeDelayedInitialize(PluginSpec *spec);
     // Plugin operations
     static QList<PluginSpec *> loadQueue();
     static void loadPlugins();
@@ -169,6 +184,19 @@ signals:
     void testsFinished(int failedTests);
     void scenarioFinished(int exitCode);
 
+private:
+    template<typename T>
+    static QObjectList objectsOfType()
+    {
+        if constexpr (std::is_base_of_v<QObject, T>) {
+            return objectsOfClass(&T::staticMetaObject);
+        } else {
+            return objectsOfInterface(qobject_interface_iid<T *>());
+        }
+    }
+    static QObjectList objectsOfClass(const QMetaObject *metaObject);
+    static QObjectList objectsOfInterface(const char *iid);
+
     friend class Internal::PluginManagerPrivate;
 };
 
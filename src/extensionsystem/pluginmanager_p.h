@@ -7,6 +7,7 @@
 #include "pluginmanager.h"
 
 #include <utils/algorithm.h>
+#include <utils/tracewriter.h>
 
 #include <QElapsedTimer>
 #include <QMutex>
@@ -18,6 +19,9 @@
 #include <QTimer>
 #include <QWaitCondition>
 
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <queue>
 
 QT_BEGIN_NAMESPACE
@@ -49,7 +53,9 @@ public:
     // Plugin operations
     void checkForProblematicPlugins();
     void loadPlugins();
+    void preloadLibraries(const PluginSpecs &queue);
     void loadPluginsAtRuntime(const QSet<PluginSpec *> &plugins);
+    void prioritizeDelayedInitialize(PluginSpec *spec);
     void addPlugins(const QList<PluginSpec *> &specs);
 
     void shutdown();
@@ -60,6 +66,7 @@ public:
     void enableDependenciesIndirectly();
     void increaseProfilingVerbosity();
     void enableTracing(const QString &filePath);
+    void traceObjectCount();
     QString profilingSummary(qint64 *totalOut = nullptr) const;
     void printProfilingSummary() const;
     void profilingReport(const char *what, const PluginSpec *spec, qint64 *target = nullptr);
@@ -100,10 +107,34 @@ public:
 
     QHash<QString, QList<PluginSpec *>> pluginCategories;
     QList<PluginSpec *> pluginSpecs;
+    // Indexes of pluginSpecs, updated by addPlugins()
+    QHash<QString, PluginSpecs> m_pluginsById;
+    QHash<QString, PluginSpec *> m_pluginsByOption;
     std::vector<TestSpec> testSpecs;
     Utils::FilePaths pluginPaths;
     QString pluginIID;
     QObjectList allObjects;      // ### make this a QList<QPointer<QObject> > > ?
+
+    // Type index of allObjects, in insertion order. A new snapshot is published on every
+    // change, so PluginManager::getObject() never waits for m_lock or for writers.
+    struct ObjectIndex
+    {
+        // Every class in the superclass chain of an object, down to QObject.
+        QHash<const QMetaObject *, QObjectList> byClass;
+        // Interfaces are only indexed once they have been asked for.
+        QHash<QByteArray, QObjectList> byInterface;
+        // Meta object at the time of addObject(); removeObject() may run from a base destructor.
+        QHash<QObject *, const QMetaObject *> classOf;
+    };
+    void indexObject(QObject *obj);
+    void unindexObject(QObject *obj);
+    QObjectList indexInterface(const char *iid);
+    std::shared_ptr<const ObjectIndex> objectIndex() const;
+    void publishObjectIndex(std::shared_ptr<const ObjectIndex> index);
+    // Only held to copy or swap the pointer (libc++ has no std::atomic<std::shared_ptr>).
+    mutable QMutex m_objectIndexPointerMutex;
+    std::shared_ptr<const ObjectIndex> m_objectIndex = std::make_shared<ObjectIndex>();
+    QMutex m_objectIndexMutex; // serializes index updates
     QStringList defaultDisabledPlugins; // Plugins/Ignored from install settings
     QStringList defaultEnabledPlugins; // Plugins/ForceEnabled from install settings
     QStringList disabledPlugins;
@@ -111,7 +142,10 @@ public:
     QStringList pluginsWithAcceptedTermsAndConditions;
     // delayed initialization
     QTimer delayedInitializeTimer;
-    std::queue<PluginSpec *> delayedInitializeQueue;
+    std::deque<PluginSpec *> delayedInitializeQueue;
+    std::chrono::milliseconds m_delayedInitializeBudget{10}; // per slice
+    int m_delayedInitializeSlices = 0;
+    int m_delayedInitializeOverruns = 0;
     // ansynchronous shutdown
     QSet<PluginSpec *> asynchronousPlugins;  // plugins that have requested async shutdown
     QEventLoop *shutdownEventLoop = nullptr; // used for async shutdown
@@ -119,10 +153,11 @@ public:
     QStringList arguments;
     QStringList argumentsForRestart;
     QScopedPointer<QElapsedTimer> m_profileTimer;
-    qint64 m_profileElapsedMS = 0;
+    qint64 m_profileElapsedNS = 0;
     qint64 m_totalUntilDelayedInitialize = 0;
     qint64 m_totalStartupMS = 0;
     unsigned m_profilingVerbosity = 0;
+    std::shared_ptr<Utils::TraceWriter> m_traceWriter;
 
     std::function<bool(PluginSpec *)> acceptTermsAndConditionsCallback;
 
@@ -136,6 +171,7 @@ public:
 
     bool m_isInitializationDone = false;
     bool enableCrashCheck = true;
+    bool m_parallelLoading = false;
     bool m_isShuttingDown = false;
 
     QHash<QString, std::function<bool()>> m_scenarios;
@@ -152,10 +188,18 @@ private:
     PluginManager *q;
 
     void startDelayedInitialize();
+    bool runDelayedInitializeSlice();
 
-    bool loadQueue(PluginSpec *spec,
-                   QList<ExtensionSystem::PluginSpec *> &queue,
-                   QList<ExtensionSystem::PluginSpec *> &circularityCheckQueue);
+    struct LoadQueueState
+    {
+        PluginSpecs queue;
+        QSet<PluginSpec *> queued;
+        PluginSpecs circularityCheckQueue;
+        QSet<PluginSpec *> circularityCheck;
+    };
+    bool loadQueue(PluginSpec *spec, LoadQueueState &state);
+    void indexPlugins(const PluginSpecs &specs);
+    PluginSpecs dependencyCandidates(const PluginSpec *spec) const;
     void stopAll();
     void deleteAll();
     void checkForDuplicatePlugins();
@@ -6,6 +6,7 @@
 #include "extensionsystemtr.h"
 #include "iplugin.h"
 #include "pluginmanager.h"
+#include "pluginspeccache.h"
 
 #include <utils/algorithm.h>
 #include <utils/appinfo.h>
@@ -177,6 +178,9 @@ class PluginSpecImplPrivate
 public:
     std::optional<QPluginLoader> loader;
     std::optional<QStaticPlugin> staticPlugin;
+    // Set for specs read from the plugin spec cache. The loader is only created,
+    // and the meta data re-validated against the library, in ensurePluginLoader().
+    std::optional<QJsonObject> cachedMetaData;
 
     IPlugin *plugin = nullptr;
 };
@@ -815,6 +819,22 @@ namespace {
     const char TERMSANDCONDITIONS[] = "TermsAndConditions";
 }
 
+// Returns false if the loader does not find a library at filePath.
+static bool createPluginLoader(std::optional<QPluginLoader> &loader, const FilePath &filePath)
+{
+    loader.emplace();
+
+    if (Utils::HostOsInfo::isMacHost())
+        loader->setLoadHints(QLibrary::ExportExternalSymbolsHint);
+
+    // Note: This already reads the meta data from the library.
+    loader->setFileName(filePath.toFSPathString());
+    // Specs may be read on a worker thread, the library is loaded on the main thread.
+    if (QCoreApplication *app = QCoreApplication::instance())
+        loader->moveToThread(app->thread());
+    return !loader->fileName().isEmpty();
+}
+
 /*!
     \internal
     Returns false if the file does not represent a Qt Creator plugin.
@@ -827,13 +847,7 @@ Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(const FilePath &fileName)
 
     spec->setLocation(absPath.parentDir());
     spec->setFilePath(absPath);
-    spec->d->loader.emplace();
-
-    if (Utils::HostOsInfo::isMacHost())
-        spec->d->loader->setLoadHints(QLibrary::ExportExternalSymbolsHint);
-
-    spec->d->loader->setFileName(absPath.toFSPathString());
-    if (spec->d->loader->fileName().isEmpty())
+    if (!createPluginLoader(spec->d->loader, absPath))
         return ResultError(::ExtensionSystem::Tr::tr("Cannot open file"));
 
     Result<> r = spec->readMetaData(spec->d->loader->metaData());
@@ -843,6 +857,24 @@ Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(const FilePath &fileName)
     return spec;
 }
 
+Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(const FilePath &fileName,
+                                                       const QJsonObject &cachedMetaData)
+{
+    auto spec = std::unique_ptr<CppPluginSpec>(new CppPluginSpec());
+
+    const FilePath absPath = fileName.absoluteFilePath();
+
+    spec->setLocation(absPath.parentDir());
+    spec->setFilePath(absPath);
+    spec->d->cachedMetaData = cachedMetaData;
+
+    Result<> r = spec->readMetaData(cachedMetaData);
+    if (!r)
+        return ResultError(r.error());
+
+    return spec;
+}
+
 Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(const QStaticPlugin &plugin)
 {
     auto spec = std::unique_ptr<CppPluginSpec>(new CppPluginSpec());
@@ -1355,6 +1387,41 @@ void PluginSpec::setError(const QString &errorString)
     d->errorString = errorString;
 }
 
+/*!
+    \internal
+    Creates the loader of a spec that was read from the plugin spec cache, and checks
+    that the library still has the cached meta data.
+*/
+bool CppPluginSpec::ensurePluginLoader()
+{
+    if (!d->cachedMetaData || d->loader)
+        return true;
+    if (!createPluginLoader(d->loader, filePath())) {
+        d->loader.reset();
+        setError(filePath().toUserOutput() + QString::fromLatin1(": ")
+                 + ::ExtensionSystem::Tr::tr("Cannot open file"));
+        return false;
+    }
+    if (d->loader->metaData() != *d->cachedMetaData) {
+        Internal::PluginSpecCache::invalidate();
+        setError(::ExtensionSystem::Tr::tr(
+            "The plugin has changed since its meta data was cached. Restart to reload it."));
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+*/
+void CppPluginSpec::preloadLibrary()
+{
+    if (hasError() || state() != PluginSpec::Resolved || !ensurePluginLoader())
+        return;
+    if (d->loader)
+        d->loader->load();
+}
+
 /*!
     \internal
 */
@@ -1369,6 +1436,8 @@ bool CppPluginSpec::loadLibrary()
         setError(::ExtensionSystem::Tr::tr("Loading the library failed because state != Resolved"));
         return false;
     }
+    if (!ensurePluginLoader())
+        return false;
     if (d->loader && !d->loader->load()) {
         setError(filePath().toUserOutput() + QString::fromLatin1(": ") + d->loader->errorString());
         return false;
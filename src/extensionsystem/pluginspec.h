@@ -67,16 +67,20 @@ struct EXTENSIONSYSTEM_EXPORT PluginArgumentDescription
 
 struct EXTENSIONSYSTEM_EXPORT PerformanceData
 {
+    qint64 preload = 0; // library mapped on a worker thread, see PluginManager::setParallelLoadingEnabled()
     qint64 load = 0;
     qint64 initialize = 0;
     qint64 extensionsInitialized = 0;
     qint64 delayedInitialize = 0;
 
-    qint64 total() const { return load + initialize + extensionsInitialized + delayedInitialize; }
+    qint64 total() const
+    {
+        return preload + load + initialize + extensionsInitialized + delayedInitialize;
+    }
     QString summary() const
     {
         return QString("l: %1ms, i: %2ms, x: %3ms, d: %4ms")
-            .arg(load, 3)
+            .arg(preload + load, 3)
             .arg(initialize, 3)
             .arg(extensionsInitialized, 3)
             .arg(delayedInitialize, 3);
@@ -171,6 +175,9 @@ protected:
     virtual void setForceEnabled(bool value);
 
     virtual bool loadLibrary() = 0;
+    // May be called on a worker thread before loadLibrary() to map the library and run its
+    // static initializers. Errors are reported by the following loadLibrary().
+    virtual void preloadLibrary() {}
     virtual bool initializePlugin() = 0;
     virtual bool initializeExtensions() = 0;
     virtual bool delayedInitialize() = 0;
@@ -199,6 +206,9 @@ EXTENSIONSYSTEM_EXPORT Utils::Result<std::unique_ptr<PluginSpec>> readCppPluginS
     const Utils::FilePath &filePath);
 EXTENSIONSYSTEM_EXPORT Utils::Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(
     const QStaticPlugin &plugin);
+// Reconstructs a spec from cached QPluginLoader meta data without opening the library.
+EXTENSIONSYSTEM_EXPORT Utils::Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(
+    const Utils::FilePath &filePath, const QJsonObject &cachedMetaData);
 
 class EXTENSIONSYSTEM_TEST_EXPORT CppPluginSpec : public PluginSpec
 {
@@ -206,6 +216,8 @@ class EXTENSIONSYSTEM_TEST_EXPORT CppPluginSpec : public PluginSpec
         const Utils::FilePath &filePath);
     friend EXTENSIONSYSTEM_EXPORT Utils::Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(
         const QStaticPlugin &plugin);
+    friend EXTENSIONSYSTEM_EXPORT Utils::Result<std::unique_ptr<PluginSpec>> readCppPluginSpec(
+        const Utils::FilePath &filePath, const QJsonObject &cachedMetaData);
 
 public:
     ~CppPluginSpec() override;
@@ -214,6 +226,7 @@ public:
     IPlugin *plugin() const override;
 
     bool loadLibrary() override;
+    void preloadLibrary() override;
     bool initializePlugin() override;
     bool initializeExtensions() override;
     bool delayedInitialize() override;
@@ -227,6 +240,8 @@ public:
 protected:
     CppPluginSpec();
 
+    bool ensurePluginLoader();
+
 private:
     std::unique_ptr<Internal::PluginSpecImplPrivate> d;
     friend class PluginView;
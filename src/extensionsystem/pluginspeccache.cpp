@@ -0,0 +1,175 @@
+#include "pluginspeccache.h"
+
+#include <utils/utils.hpp>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+Q_LOGGING_CATEGORY(pluginSpecCacheLog, "qtc.extensionsystem.speccache", QtWarningMsg)
+
+namespace ExtensionSystem::Internal {
+
+const int cacheFormatVersion = 1;
+
+static QString cacheFilePath()
+{
+    return Utils::cachePath() + "/pluginspecs.json";
+}
+
+PluginSpecCache::PluginSpecCache(const QString &pluginIID)
+    : m_pluginIID(pluginIID)
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != cacheFormatVersion
+        || root.value("qtVersion").toString() != QLatin1String(qVersion())
+        || root.value("iid").toString() != m_pluginIID) {
+        qCDebug(pluginSpecCacheLog) << "Ignoring outdated plugin spec cache" << file.fileName();
+        m_modified = true;
+        return;
+    }
+
+    const QJsonArray plugins = root.value("plugins").toArray();
+    for (const QJsonValue &value : plugins) {
+        const QJsonObject object = value.toObject();
+        CacheEntry cacheEntry;
+        cacheEntry.stamp.size = object.value("size").toInteger(-1);
+        cacheEntry.stamp.modified = object.value("modified").toInteger();
+        cacheEntry.stamp.fileId = object.value("fileId").toString();
+        cacheEntry.entry.metaData = object.value("metaData").toObject();
+        cacheEntry.entry.error = object.value("error").toString();
+        m_entries.insert(object.value("path").toString(), cacheEntry);
+    }
+}
+
+PluginSpecCache::FileStamp PluginSpecCache::fileStamp(const Utils::FilePath &filePath)
+{
+    FileStamp stamp;
+    const QString path = filePath.toFSPathString();
+#ifdef Q_OS_WIN
+    const HANDLE handle = CreateFileW(reinterpret_cast<const wchar_t *>(path.utf16()),
+                                      FILE_READ_ATTRIBUTES,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_FLAG_BACKUP_SEMANTICS,
+                                      nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return stamp;
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandle(handle, &info)) {
+        stamp.size = (qint64(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+        // FILETIME counts 100ns intervals since 1601. Rebase it to the Unix epoch first;
+        // scaling the raw count to nanoseconds would overflow qint64.
+        const qint64 fileTimeToUnixEpoch = 116444736000000000;
+        stamp.modified = (((qint64(info.ftLastWriteTime.dwHighDateTime) << 32)
+                           | info.ftLastWriteTime.dwLowDateTime)
+                          - fileTimeToUnixEpoch)
+                         * 100;
+        stamp.fileId = QString("%1:%2")
+                           .arg(info.dwVolumeSerialNumber)
+                           .arg((quint64(info.nFileIndexHigh) << 32) | info.nFileIndexLow);
+    }
+    CloseHandle(handle);
+#else
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0)
+        return stamp;
+    stamp.size = st.st_size;
+#ifdef Q_OS_MACOS
+    stamp.modified = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    stamp.modified = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    stamp.fileId = QString("%1:%2").arg(quint64(st.st_dev)).arg(quint64(st.st_ino));
+#endif
+    return stamp;
+}
+
+void PluginSpecCache::invalidate()
+{
+    QFile::remove(cacheFilePath());
+}
+
+std::optional<PluginSpecCache::Entry> PluginSpecCache::find(const Utils::FilePath &filePath,
+                                                            const FileStamp &stamp) const
+{
+    if (!stamp.isValid())
+        return {};
+    const auto it = m_entries.constFind(filePath.toFSPathString());
+    if (it == m_entries.cend())
+        return {};
+    if (!(it->stamp == stamp)) {
+        qCDebug(pluginSpecCacheLog) << "Plugin changed since it was cached" << filePath;
+        return {};
+    }
+    return it->entry;
+}
+
+void PluginSpecCache::insert(const Utils::FilePath &filePath,
+                             const FileStamp &stamp,
+                             const Entry &entry)
+{
+    if (!stamp.isValid())
+        return;
+    const QString key = filePath.toFSPathString();
+    const auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->stamp == stamp) {
+        it->used = true;
+        return;
+    }
+    m_entries.insert(key, {stamp, entry, true});
+    m_modified = true;
+}
+
+void PluginSpecCache::save()
+{
+    QJsonArray plugins;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (!it->used) {
+            m_modified = true; // removed or no longer in a plugin path
+            continue;
+        }
+        QJsonObject object;
+        object["path"] = it.key();
+        object["size"] = it->stamp.size;
+        object["modified"] = it->stamp.modified;
+        object["fileId"] = it->stamp.fileId;
+        if (it->entry.error.isEmpty())
+            object["metaData"] = it->entry.metaData;
+        else
+            object["error"] = it->entry.error;
+        plugins.append(object);
+    }
+    if (!m_modified)
+        return;
+
+    QJsonObject root;
+    root["version"] = cacheFormatVersion;
+    root["qtVersion"] = QLatin1String(qVersion());
+    root["iid"] = m_pluginIID;
+    root["plugins"] = plugins;
+
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson()) < 0
+        || !file.commit()) {
+        qCWarning(pluginSpecCacheLog)
+            << "Cannot write plugin spec cache" << file.fileName() << file.errorString();
+        return;
+    }
+    m_modified = false;
+}
+
+} // namespace ExtensionSystem::Internal
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <utils/filepath.h>
+
+#include <QHash>
+#include <QJsonObject>
+
+#include <optional>
+
+namespace ExtensionSystem::Internal {
+
+// On-disk cache of plugin meta data, so that unchanged plugin libraries do not have
+// to be opened by QPluginLoader on every start. Entries are keyed by the absolute
+// path and validated against size, modification time and file id.
+class PluginSpecCache
+{
+public:
+    struct FileStamp
+    {
+        qint64 size = -1;
+        qint64 modified = 0; // nanoseconds since 1970-01-01 UTC, on all platforms
+        QString fileId;      // device/inode or volume/file index
+
+        bool isValid() const { return size >= 0; }
+        bool operator==(const FileStamp &other) const
+        {
+            return size == other.size && modified == other.modified && fileId == other.fileId;
+        }
+    };
+
+    struct Entry
+    {
+        QJsonObject metaData; // as returned by QPluginLoader::metaData()
+        QString error;        // set if the file is not a valid plugin
+    };
+
+    explicit PluginSpecCache(const QString &pluginIID);
+
+    static FileStamp fileStamp(const Utils::FilePath &filePath);
+    // Removes the cache file, e.g. after a cached entry turned out to be stale.
+    static void invalidate();
+
+    // Thread safe as long as no other member function is called concurrently.
+    std::optional<Entry> find(const Utils::FilePath &filePath, const FileStamp &stamp) const;
+    // Records the entry for a file seen in this scan. Re-inserting an unchanged entry only
+    // marks it as still in use.
+    void insert(const Utils::FilePath &filePath, const FileStamp &stamp, const Entry &entry);
+    // Writes the cache if anything changed. Entries not inserted since construction are dropped.
+    void save();
+
+private:
+    struct CacheEntry
+    {
+        FileStamp stamp;
+        Entry entry;
+        bool used = false;
+    };
+
+    QString m_pluginIID;
+    QHash<QString, CacheEntry> m_entries;
+    bool m_modified = false;
+};
+
+} // namespace ExtensionSystem::Internal
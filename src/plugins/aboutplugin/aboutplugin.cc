@@ -12,10 +12,15 @@ class AboutPluginWidget : public Core::CoreWidget
     Q_OBJECT
 public:
     explicit AboutPluginWidget(QObject *parent = nullptr)
+        : Core::CoreWidget(parent)
     {
-        auto *aboutWidget = new AboutWidget;
-        aboutWidget->setObjectName("AboutWidget");
-        setWidget(aboutWidget);
+        setWidgetFactory(
+            [] {
+                auto *aboutWidget = new AboutWidget;
+                aboutWidget->setObjectName("AboutWidget");
+                return aboutWidget;
+            },
+            true);
         setButton(new QPushButton(tr("About")), Core::CoreWidget::Help);
     }
 };
@@ -6,6 +6,7 @@
 #include <extensionsystem/iplugin.h>
 #include <extensionsystem/pluginmanager.h>
 #include <utils/guiutils.h>
+#include <utils/startuptimeline.hpp>
 #include <utils/utils.hpp>
 
 #include <QApplication>
@@ -46,6 +47,7 @@ public:
         m_corePtr.reset(new ICore);
         m_mainWindowPtr.reset(new MainWindow);
         mainwindowPtr = m_mainWindowPtr.data();
+        Utils::StartupTimeline::markFirstPaint(mainwindowPtr, "mainWindowFirstPaint");
         Utils::setDialogParentGetter(dialogParent);
 
         return Utils::ResultOk;
@@ -3,7 +3,10 @@
 #include "plugindialog.h"
 
 #include <core/corewidget.hpp>
+#include <extensionsystem/iplugin.h>
 #include <extensionsystem/pluginmanager.h>
+#include <extensionsystem/pluginspec.h>
+#include <utils/hostosinfo.h>
 #include <utils/singletonmanager.hpp>
 #include <utils/utils.hpp>
 #include <widgets/messagebox.h>
@@ -57,8 +60,54 @@ public:
         widget->setGraphicsEffect(blurEffect);
     }
 
+    void showPage(Core::CoreWidget *page) const
+    {
+        prioritizeOwningPlugin(page);
+        auto *widget = page->ensureWidget();
+        if (widget == nullptr) {
+            return;
+        }
+        if (stackedWidget->indexOf(widget) < 0) {
+            stackedWidget->addWidget(widget);
+        }
+        stackedWidget->setCurrentWidget(widget);
+    }
+
+    // 页面显示后，其所属插件的 delayedInitialize() 排到其他插件之前执行
+    static void prioritizeOwningPlugin(Core::CoreWidget *page)
+    {
+        if (ExtensionSystem::PluginManager::isInitializationDone()) {
+            return;
+        }
+        const auto specs = ExtensionSystem::PluginManager::plugins();
+        for (auto *const spec : specs) {
+            if (spec->plugin() != nullptr && spec->plugin() == page->parent()) {
+                ExtensionSystem::PluginManager::prioritizeDelayedInitialize(spec);
+                return;
+            }
+        }
+    }
+
+    // 可用物理内存低于 10% 时，释放当前未显示且允许释放的页面
+    void releaseIdlePagesUnderMemoryPressure() const
+    {
+        const auto total = Utils::HostOsInfo::totalMemoryInstalledInBytes();
+        const auto available = Utils::HostOsInfo::availableMemoryInBytes();
+        if (!total || !available || *available * 10 >= *total) {
+            return;
+        }
+        auto *current = stackedWidget->currentWidget();
+        for (auto *const page : std::as_const(pages)) {
+            if (page->isReleasableWhenIdle() && page->widget() != current) {
+                page->releaseWidget();
+            }
+        }
+    }
+
     MainWindow *q_ptr;
 
+    Core::CoreWidgetList pages;
+    QTimer *memoryPressureTimer = nullptr;
     QButtonGroup *switchBtnGroup;
     QButtonGroup *menuBtnGroup;
     QStackedWidget *stackedWidget;
@@ -194,8 +243,8 @@ void MainWindow::extensionsInitialized()
     auto coreWidgets = Core::getCoreWidgets();
 
     for (auto *const page : std::as_const(coreWidgets)) {
-        auto *widget = page->widget();
-        if (widget == nullptr) {
+        // 页面在第一次激活时才创建
+        if (!page->hasWidget()) {
             continue;
         }
         switch (page->type()) {
@@ -205,10 +254,18 @@ void MainWindow::extensionsInitialized()
         }
         auto *button = page->button();
         d_ptr->menuBtnGroup->addButton(button);
-        d_ptr->stackedWidget->addWidget(widget);
-        connect(button, &QPushButton::clicked, this, [this, page] {
-            d_ptr->stackedWidget->setCurrentWidget(page->widget());
+        connect(button, &QPushButton::clicked, this, [this, page] { d_ptr->showPage(page); });
+        d_ptr->pages.append(page);
+    }
+
+    if (std::any_of(d_ptr->pages.cbegin(), d_ptr->pages.cend(), [](Core::CoreWidget *page) {
+            return page->isReleasableWhenIdle();
+        })) {
+        d_ptr->memoryPressureTimer = new QTimer(this);
+        connect(d_ptr->memoryPressureTimer, &QTimer::timeout, this, [this] {
+            d_ptr->releaseIdlePagesUnderMemoryPressure();
         });
+        d_ptr->memoryPressureTimer->start(30 * 1000);
     }
 
     setupMenu();
@@ -12,8 +12,9 @@ class GuiPluginWidget : public Core::CoreWidget
     Q_OBJECT
 public:
     explicit GuiPluginWidget(QObject *parent = nullptr)
+        : Core::CoreWidget(parent)
     {
-        setWidget(new GuiWidget);
+        setWidgetFactory([] { return new GuiWidget; }, true);
         setButton(new QPushButton(tr("Gui")), Core::CoreWidget::Main);
     }
 };
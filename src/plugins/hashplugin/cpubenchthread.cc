@@ -13,7 +13,10 @@ public:
 
     CpuBenchThread *q_ptr;
 
+    bool suite = false;
     Params params;
+    Utils::CpuBenchOptions options;
+    std::atomic_bool canceled{false};
 };
 
 CpuBenchThread::CpuBenchThread(QObject *parent)
@@ -31,13 +34,27 @@ void CpuBenchThread::startBench(const Params &params)
     if (isRunning()) {
         return;
     }
+    d_ptr->suite = false;
     d_ptr->params = params;
+    d_ptr->canceled.store(false);
+    start();
+}
+
+void CpuBenchThread::startSuite(const Utils::CpuBenchOptions &options)
+{
+    if (isRunning()) {
+        return;
+    }
+    d_ptr->suite = true;
+    d_ptr->options = options;
+    d_ptr->canceled.store(false);
     start();
 }
 
 void CpuBenchThread::stop()
 {
     if (isRunning()) {
+        d_ptr->canceled.store(true);
         quit();
         wait();
     }
@@ -45,6 +62,16 @@ void CpuBenchThread::stop()
 
 void CpuBenchThread::run()
 {
+    if (d_ptr->suite) {
+        auto results = Utils::runCpuBenchSuite(d_ptr->options,
+                                               d_ptr->canceled,
+                                               [this](const Utils::CpuBenchResult &result) {
+                                                   emit suiteResultReady(result);
+                                               });
+        emit suiteFinished(results);
+        return;
+    }
+
     auto result = Utils::cpuBench(d_ptr->params.iterations,
                                   d_ptr->params.durationMs,
                                   d_ptr->params.dataSize,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utils/cpubench.hpp>
+
 #include <QCryptographicHash>
 #include <QThread>
 
@@ -21,10 +23,14 @@ public:
     ~CpuBenchThread() override;
 
     void startBench(const Params &params);
+    // 运行完整的基准套件（算法 × 线程数 × 缓冲区大小）
+    void startSuite(const Utils::CpuBenchOptions &options);
     void stop();
 
 signals:
     void benchFinished(double result); // MB/s
+    void suiteResultReady(const Utils::CpuBenchResult &result);
+    void suiteFinished(const QList<Utils::CpuBenchResult> &results);
 
 protected:
     void run() override;
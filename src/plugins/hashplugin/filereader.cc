@@ -0,0 +1,67 @@
+#include "filereader.hpp"
+
+#include <QFile>
+
+#ifndef Q_OS_WIN
+#include <sys/mman.h>
+#endif
+
+namespace Plugin {
+
+static const qint64 g_kMapThreshold = 4 * 1024 * 1024;    // 4MB
+static const qint64 g_kMapWindowSize = 64 * 1024 * 1024; // 64MB
+
+// 返回通过映射交给 consumer 的字节数，映射失败时由调用者从该位置继续普通读取
+static auto readMapped(QFile &file,
+                       const std::atomic_bool &running,
+                       const std::function<void(QByteArrayView)> &consumer) -> qint64
+{
+    const auto size = file.size();
+    qint64 offset = 0;
+    while (running.load() && offset < size) {
+        const auto length = qMin(g_kMapWindowSize, size - offset);
+        auto *data = file.map(offset, length);
+        if (data == nullptr) {
+            break;
+        }
+#ifndef Q_OS_WIN
+        // 窗口偏移是页大小的整数倍，映射地址按页对齐
+        madvise(data, length, MADV_SEQUENTIAL);
+#endif
+        consumer(QByteArrayView(reinterpret_cast<const char *>(data), length));
+        file.unmap(data);
+        offset += length;
+    }
+    return offset;
+}
+
+auto readFileData(QFile &file,
+                  char *buffer,
+                  qint64 bufferSize,
+                  const std::atomic_bool &running,
+                  const std::function<void(QByteArrayView)> &consumer) -> bool
+{
+    if (!file.isSequential() && file.size() >= g_kMapThreshold) {
+        const auto mapped = readMapped(file, running, consumer);
+        if (mapped == file.size() || !running.load()) {
+            return true;
+        }
+        if (!file.seek(mapped)) {
+            return false;
+        }
+    }
+
+    while (running.load()) {
+        const auto read = file.read(buffer, bufferSize);
+        if (read < 0) {
+            return false;
+        }
+        if (read == 0) {
+            break;
+        }
+        consumer(QByteArrayView(buffer, read));
+    }
+    return true;
+}
+
+} // namespace Plugin
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QByteArrayView>
+
+#include <atomic>
+#include <functional>
+
+class QFile;
+
+namespace Plugin {
+
+// 顺序读取已打开文件的全部内容并交给 consumer。
+// 较大的普通文件按大窗口映射，consumer 直接读映射页，不经过用户态拷贝；
+// 管道、设备等无法映射的文件（或映射失败时）退化为复用 buffer 的普通读取。
+// running 变为 false 时提前返回；读取出错时返回 false，原因见 file.errorString()。
+auto readFileData(QFile &file,
+                  char *buffer,
+                  qint64 bufferSize,
+                  const std::atomic_bool &running,
+                  const std::function<void(QByteArrayView)> &consumer) -> bool;
+
+} // namespace Plugin
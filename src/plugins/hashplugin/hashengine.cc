@@ -0,0 +1,261 @@
+#include "hashengine.hpp"
+#include "filereader.hpp"
+
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <memory>
+#include <vector>
+
+namespace Plugin {
+
+static const qint64 g_kReadBufferSize = 1024 * 1024; // 1MB
+
+auto HashEngine::Progress::throughput() const -> double
+{
+    if (elapsedMs <= 0) {
+        return 0.0;
+    }
+    return (bytesDone / (elapsedMs / 1000.0)) / (1024 * 1024);
+}
+
+class HashEngine::HashEnginePrivate
+{
+public:
+    explicit HashEnginePrivate(HashEngine *q)
+        : q_ptr(q)
+    {
+        progressTimer = new QTimer(q_ptr);
+        progressTimer->setInterval(200);
+        QObject::connect(progressTimer, &QTimer::timeout, q_ptr, [this] {
+            emit q_ptr->progressChanged(progress());
+        });
+    }
+
+    // 读缓冲区的数量与线程数相同，同一时刻每个线程最多占用一块
+    auto acquireBuffer() -> char *
+    {
+        QMutexLocker locker(&bufferMutex);
+        if (freeBuffers.empty()) {
+            buffers.push_back(std::make_unique<char[]>(g_kReadBufferSize));
+            return buffers.back().get();
+        }
+        auto *buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        return buffer;
+    }
+
+    void releaseBuffer(char *buffer)
+    {
+        QMutexLocker locker(&bufferMutex);
+        freeBuffers.push_back(buffer);
+    }
+
+    void resetBuffers()
+    {
+        QMutexLocker locker(&bufferMutex);
+        freeBuffers.clear();
+        buffers.resize(pool.maxThreadCount());
+        for (auto &buffer : buffers) {
+            if (!buffer) {
+                buffer = std::make_unique<char[]>(g_kReadBufferSize);
+            }
+            freeBuffers.push_back(buffer.get());
+        }
+    }
+
+    void enumerate(const QStringList &paths)
+    {
+        for (const auto &path : std::as_const(paths)) {
+            if (!running.load()) {
+                break;
+            }
+            const QFileInfo info(path);
+            if (!info.isDir()) {
+                submit(info.absoluteFilePath(), info.size());
+                continue;
+            }
+            QDirIterator it(path,
+                            QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot,
+                            QDirIterator::Subdirectories);
+            while (running.load() && it.hasNext()) {
+                it.next();
+                submit(it.filePath(), it.fileInfo().size());
+            }
+        }
+        enumerating.store(false);
+        taskDone();
+    }
+
+    void submit(const QString &filePath, qint64 size)
+    {
+        filesTotal.fetch_add(1);
+        bytesTotal.fetch_add(size);
+        pending.fetch_add(1);
+        pool.start([this, filePath, size] {
+            hashFile(filePath, size);
+            taskDone();
+        });
+    }
+
+    void hashFile(const QString &filePath, qint64 size)
+    {
+        if (!running.load()) {
+            return;
+        }
+
+        FileResult result;
+        result.filePath = filePath;
+        result.size = size;
+
+        QFile file(filePath);
+        if (file.open(QIODevice::ReadOnly)) {
+            std::vector<std::unique_ptr<QCryptographicHash>> hashes;
+            hashes.reserve(algorithms.size());
+            for (const auto algorithm : std::as_const(algorithms)) {
+                hashes.push_back(std::make_unique<QCryptographicHash>(algorithm));
+            }
+
+            auto *buffer = acquireBuffer();
+            const auto ok = readFileData(file,
+                                         buffer,
+                                         g_kReadBufferSize,
+                                         running,
+                                         [&](QByteArrayView data) {
+                                             for (const auto &hash : hashes) {
+                                                 hash->addData(data);
+                                             }
+                                             bytesDone.fetch_add(data.size());
+                                         });
+            releaseBuffer(buffer);
+            if (!ok) {
+                result.error = file.errorString();
+            }
+
+            if (result.error.isEmpty()) {
+                for (const auto &hash : hashes) {
+                    result.hashes.append(hash->result().toHex());
+                }
+            }
+        } else {
+            result.error = file.errorString();
+        }
+
+        if (!running.load()) {
+            return; // 已取消，不再上报未完成的结果
+        }
+        filesDone.fetch_add(1);
+        emit q_ptr->fileFinished(result);
+    }
+
+    void taskDone()
+    {
+        if (pending.fetch_sub(1) != 1) {
+            return;
+        }
+        running.store(false);
+        QMetaObject::invokeMethod(
+            q_ptr,
+            [this] {
+                progressTimer->stop();
+                emit q_ptr->finished(progress());
+            },
+            Qt::QueuedConnection);
+    }
+
+    auto progress() const -> Progress
+    {
+        Progress progress;
+        progress.filesDone = filesDone.load();
+        progress.filesTotal = filesTotal.load();
+        progress.bytesDone = bytesDone.load();
+        progress.bytesTotal = bytesTotal.load();
+        progress.elapsedMs = elapsedTimer.elapsed();
+        progress.enumerating = enumerating.load();
+        return progress;
+    }
+
+    HashEngine *q_ptr;
+
+    QThreadPool pool;
+    QTimer *progressTimer;
+    QElapsedTimer elapsedTimer;
+    QList<QCryptographicHash::Algorithm> algorithms;
+
+    QMutex bufferMutex;
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<char *> freeBuffers;
+
+    std::atomic_bool running{false};
+    std::atomic_bool enumerating{false};
+    std::atomic_int pending{0};
+    std::atomic_int filesDone{0};
+    std::atomic_int filesTotal{0};
+    std::atomic<qint64> bytesDone{0};
+    std::atomic<qint64> bytesTotal{0};
+};
+
+HashEngine::HashEngine(QObject *parent)
+    : QObject{parent}
+    , d_ptr{new HashEnginePrivate{this}}
+{}
+
+HashEngine::~HashEngine()
+{
+    stop();
+}
+
+void HashEngine::setMaxThreadCount(int count)
+{
+    if (isRunning() || count < 1) {
+        return;
+    }
+    d_ptr->pool.setMaxThreadCount(count);
+}
+
+auto HashEngine::maxThreadCount() const -> int
+{
+    return d_ptr->pool.maxThreadCount();
+}
+
+auto HashEngine::start(const QStringList &paths,
+                       const QList<QCryptographicHash::Algorithm> &algorithms) -> bool
+{
+    if (isRunning() || paths.isEmpty() || algorithms.isEmpty()) {
+        return false;
+    }
+    // 上一轮 stop() 之后可能还有任务在收尾
+    d_ptr->pool.waitForDone();
+
+    d_ptr->algorithms = algorithms;
+    d_ptr->resetBuffers();
+    d_ptr->filesDone.store(0);
+    d_ptr->filesTotal.store(0);
+    d_ptr->bytesDone.store(0);
+    d_ptr->bytesTotal.store(0);
+    d_ptr->pending.store(1); // 目录遍历本身也算一个任务
+    d_ptr->enumerating.store(true);
+    d_ptr->running.store(true);
+    d_ptr->elapsedTimer.start();
+    d_ptr->progressTimer->start();
+
+    d_ptr->pool.start([this, paths] { d_ptr->enumerate(paths); });
+    return true;
+}
+
+void HashEngine::stop()
+{
+    d_ptr->running.store(false);
+    d_ptr->pool.waitForDone();
+}
+
+auto HashEngine::isRunning() const -> bool
+{
+    return d_ptr->running.load();
+}
+
+} // namespace Plugin
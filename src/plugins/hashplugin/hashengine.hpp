@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QCryptographicHash>
+#include <QObject>
+
+namespace Plugin {
+
+// 多文件并行哈希：输入可以是文件或目录（递归），按文件分发到线程池，
+// 每个文件只读一遍并同时计算多个算法，读缓冲区在整个任务期间复用。
+class HashEngine : public QObject
+{
+    Q_OBJECT
+public:
+    struct FileResult
+    {
+        QString filePath;
+        qint64 size = 0;
+        QList<QByteArray> hashes; // 与 start() 传入的 algorithms 一一对应，十六进制
+        QString error;
+    };
+
+    struct Progress
+    {
+        int filesDone = 0;
+        int filesTotal = 0;
+        qint64 bytesDone = 0;
+        qint64 bytesTotal = 0;
+        qint64 elapsedMs = 0;
+        bool enumerating = true; // 目录仍在遍历中，总数还会增长
+
+        [[nodiscard]] auto throughput() const -> double; // MB/s
+    };
+
+    explicit HashEngine(QObject *parent = nullptr);
+    ~HashEngine() override;
+
+    void setMaxThreadCount(int count);
+    [[nodiscard]] auto maxThreadCount() const -> int;
+
+    auto start(const QStringList &paths, const QList<QCryptographicHash::Algorithm> &algorithms)
+        -> bool;
+    void stop();
+    [[nodiscard]] auto isRunning() const -> bool;
+
+signals:
+    void fileFinished(const Plugin::HashEngine::FileResult &result);
+    void progressChanged(const Plugin::HashEngine::Progress &progress);
+    void finished(const Plugin::HashEngine::Progress &progress);
+
+private:
+    class HashEnginePrivate;
+    QScopedPointer<HashEnginePrivate> d_ptr;
+};
+
+} // namespace Plugin
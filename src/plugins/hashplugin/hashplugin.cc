@@ -12,8 +12,9 @@ class HashPluginWidget : public Core::CoreWidget
     Q_OBJECT
 public:
     explicit HashPluginWidget(QObject *parent = nullptr)
+        : Core::CoreWidget(parent)
     {
-        setWidget(new HashWidget);
+        setWidgetFactory([] { return new HashWidget; });
         setButton(new QPushButton(tr("Hash")), Core::CoreWidget::Main);
     }
 };
@@ -16,11 +16,15 @@ include(../../../qmake/VcpkgToolchain.pri)
 
 HEADERS += \
     cpubenchthread.hpp \
+    filereader.hpp \
+    hashengine.hpp \
     hashthread.hpp \
     hashwidget.hpp
 
 SOURCES += \
     cpubenchthread.cc \
+    filereader.cc \
+    hashengine.cc \
     hashplugin.cc \
     hashthread.cc \
     hashwidget.cc
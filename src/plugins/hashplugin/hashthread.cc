@@ -1,4 +1,5 @@
 #include "hashthread.hpp"
+#include "filereader.hpp"
 
 #include <QFile>
 
@@ -54,10 +55,10 @@ void HashThread::run()
     QCryptographicHash hashObj{d_ptr->algorithm};
     QFile file{d_ptr->input};
     if (file.exists() && file.open(QIODevice::ReadOnly)) {
-        while (d_ptr->running.load() && !file.atEnd()) {
-            auto data = file.read(1024 * 1024); // 1MB
+        QByteArray buffer(1024 * 1024, Qt::Uninitialized); // 1MB，无法映射时复用
+        readFileData(file, buffer.data(), buffer.size(), d_ptr->running, [&](QByteArrayView data) {
             hashObj.addData(data);
-        }
+        });
     } else {
         hashObj.addData(d_ptr->input.toUtf8());
     }
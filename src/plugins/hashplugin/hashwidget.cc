@@ -2,6 +2,7 @@
 #include "cpubenchthread.hpp"
 #include "hashthread.hpp"
 
+#include <utils/utils.hpp>
 #include <widgets/messagebox.h>
 
 #include <QtWidgets>
@@ -25,6 +26,28 @@ static QComboBox *createHashComboBox(QWidget *parent)
     return comboBox;
 }
 
+static QListWidget *createHashListWidget(QWidget *parent)
+{
+    auto *listWidget = new QListWidget(parent);
+    listWidget->setFlow(QListView::LeftToRight);
+    listWidget->setWrapping(true);
+    listWidget->setMaximumHeight(80);
+    auto metaEnums = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (int i = 0; i < metaEnums.keyCount(); ++i) {
+        auto value = metaEnums.value(i);
+        if (value == QCryptographicHash::NumAlgorithms) {
+            continue;
+        }
+        auto *item = new QListWidgetItem(metaEnums.key(i), listWidget);
+        item->setData(Qt::UserRole, value);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        const auto checked = value == QCryptographicHash::Md5
+                             || value == QCryptographicHash::Sha256;
+        item->setCheckState(checked ? Qt::Checked : Qt::Unchecked);
+    }
+    return listWidget;
+}
+
 class HashWidget::HashWidgetPrivate
 {
 public:
@@ -52,6 +75,39 @@ public:
 
         cpuBenchThread = new CpuBenchThread(q_ptr);
 
+        suiteAlgorithmList = createHashListWidget(q_ptr);
+        suiteIterationsSpinBox = new QSpinBox(q_ptr);
+        suiteIterationsSpinBox->setSizePolicy(sizePolicy);
+        suiteIterationsSpinBox->setRange(1, 1000);
+        suiteIterationsSpinBox->setValue(5);
+        suiteDurationSpinBox = new QSpinBox(q_ptr);
+        suiteDurationSpinBox->setSizePolicy(sizePolicy);
+        suiteDurationSpinBox->setRange(10, INT_MAX);
+        suiteDurationSpinBox->setValue(200);
+        suiteStatusLabel = new QLabel(q_ptr);
+        suiteStartButton = new QPushButton(HashWidget::tr("Run Suite"), q_ptr);
+        suiteStartButton->setToolTip(
+            HashWidget::tr("Benchmark the checked algorithms with 1 to %1 threads "
+                           "and buffers from 4 KB to 64 MB.")
+                .arg(QThread::idealThreadCount()));
+        suiteStartButton->setObjectName("BlueButton");
+        suiteExportButton = new QPushButton(HashWidget::tr("Export"), q_ptr);
+        suiteExportButton->setToolTip(HashWidget::tr("Export results as JSON or CSV."));
+        suiteExportButton->setObjectName("BlueButton");
+        suiteExportButton->setEnabled(false);
+        suiteResultView = new QTreeWidget(q_ptr);
+        suiteResultView->setRootIsDecorated(false);
+        suiteResultView->setUniformRowHeights(true);
+        suiteResultView->setHeaderLabels({HashWidget::tr("Algorithm"),
+                                          HashWidget::tr("Threads"),
+                                          HashWidget::tr("Buffer"),
+                                          HashWidget::tr("Median (MB/s)"),
+                                          HashWidget::tr("P95 (MB/s)"),
+                                          HashWidget::tr("Min (MB/s)"),
+                                          HashWidget::tr("Scaling")});
+
+        suiteThread = new CpuBenchThread(q_ptr);
+
         hashComboBox = createHashComboBox(q_ptr);
         selectFileButton = new QPushButton(HashWidget::tr("Select File"), q_ptr);
         selectFileButton->setToolTip(HashWidget::tr("Select file to calculate hash."));
@@ -63,6 +119,80 @@ public:
         outputEdit = new QTextEdit(q_ptr);
 
         hashThread = new HashThread(q_ptr);
+
+        batchAlgorithmList = createHashListWidget(q_ptr);
+        batchInputEdit = new QPlainTextEdit(q_ptr);
+        batchInputEdit->setPlaceholderText(HashWidget::tr("One file or directory per line."));
+        batchInputEdit->setMaximumHeight(80);
+        batchAddFilesButton = new QPushButton(HashWidget::tr("Add Files"), q_ptr);
+        batchAddFilesButton->setObjectName("BlueButton");
+        batchAddDirectoryButton = new QPushButton(HashWidget::tr("Add Directory"), q_ptr);
+        batchAddDirectoryButton->setObjectName("BlueButton");
+        batchStartButton = new QPushButton(HashWidget::tr("Start"), q_ptr);
+        batchStartButton->setToolTip(
+            HashWidget::tr("Hash all files in parallel with the checked algorithms."));
+        batchStartButton->setObjectName("BlueButton");
+        batchStatusLabel = new QLabel(q_ptr);
+        batchResultView = new QTreeWidget(q_ptr);
+        batchResultView->setRootIsDecorated(false);
+        batchResultView->setUniformRowHeights(true);
+        batchResultView->setSortingEnabled(true);
+
+        hashEngine = new HashEngine(q_ptr);
+    }
+
+    auto checkedBatchAlgorithms() const -> QList<QCryptographicHash::Algorithm>
+    {
+        QList<QCryptographicHash::Algorithm> algorithms;
+        for (int i = 0; i < batchAlgorithmList->count(); ++i) {
+            auto *item = batchAlgorithmList->item(i);
+            if (item->checkState() == Qt::Checked) {
+                algorithms.append(
+                    static_cast<QCryptographicHash::Algorithm>(item->data(Qt::UserRole).toInt()));
+            }
+        }
+        return algorithms;
+    }
+
+    auto suiteOptions() const -> Utils::CpuBenchOptions
+    {
+        Utils::CpuBenchOptions options;
+        for (int i = 0; i < suiteAlgorithmList->count(); ++i) {
+            auto *item = suiteAlgorithmList->item(i);
+            if (item->checkState() == Qt::Checked) {
+                options.algorithms.append(
+                    static_cast<QCryptographicHash::Algorithm>(item->data(Qt::UserRole).toInt()));
+            }
+        }
+        options.threadCounts = Utils::CpuBenchOptions::defaultThreadCounts();
+        options.bufferSizes = Utils::CpuBenchOptions::defaultBufferSizes();
+        options.iterations = suiteIterationsSpinBox->value();
+        options.durationMs = suiteDurationSpinBox->value();
+        return options;
+    }
+
+    void setSuiteRunning(bool running) const
+    {
+        suiteStartButton->setText(running ? HashWidget::tr("Stop") : HashWidget::tr("Run Suite"));
+        suiteExportButton->setEnabled(!running && !suiteResults.isEmpty());
+        suiteAlgorithmList->setEnabled(!running);
+        suiteIterationsSpinBox->setEnabled(!running);
+        suiteDurationSpinBox->setEnabled(!running);
+    }
+
+    void appendBatchInput(const QStringList &paths) const
+    {
+        for (const auto &path : std::as_const(paths)) {
+            batchInputEdit->appendPlainText(QDir::toNativeSeparators(path));
+        }
+    }
+
+    void setBatchRunning(bool running) const
+    {
+        batchStartButton->setText(running ? HashWidget::tr("Stop") : HashWidget::tr("Start"));
+        batchAddFilesButton->setEnabled(!running);
+        batchAddDirectoryButton->setEnabled(!running);
+        batchAlgorithmList->setEnabled(!running);
     }
 
     void setupUI() const
@@ -82,12 +212,60 @@ public:
         auto *layout = new QVBoxLayout(q_ptr);
         layout->setSpacing(10);
         layout->addWidget(createHashTestGroup());
+        layout->addWidget(createBenchSuiteGroup());
         layout->addWidget(descriptionLabel);
         layout->addWidget(new QLabel(HashWidget::tr("Input:"), q_ptr));
         layout->addWidget(inputEdit);
         layout->addLayout(buttonLayout);
         layout->addWidget(new QLabel(HashWidget::tr("Output:"), q_ptr));
         layout->addWidget(outputEdit);
+        layout->addWidget(createBatchHashGroup());
+    }
+
+    QGroupBox *createBatchHashGroup() const
+    {
+        auto *buttonLayout = new QHBoxLayout;
+        buttonLayout->setSpacing(20);
+        buttonLayout->addWidget(batchAddFilesButton);
+        buttonLayout->addWidget(batchAddDirectoryButton);
+        buttonLayout->addStretch();
+        buttonLayout->addWidget(batchStatusLabel);
+        buttonLayout->addWidget(batchStartButton);
+
+        auto *groupBox = new QGroupBox(HashWidget::tr("Batch Hash"), q_ptr);
+        auto *layout = new QVBoxLayout(groupBox);
+        layout->addWidget(new QLabel(HashWidget::tr("Algorithms:"), q_ptr));
+        layout->addWidget(batchAlgorithmList);
+        layout->addWidget(batchInputEdit);
+        layout->addLayout(buttonLayout);
+        layout->addWidget(batchResultView);
+        return groupBox;
+    }
+
+    QGroupBox *createBenchSuiteGroup() const
+    {
+        auto *settingLayout = new QHBoxLayout;
+        settingLayout->setSpacing(20);
+        settingLayout->addWidget(new QLabel(HashWidget::tr("Samples:"), q_ptr));
+        settingLayout->addWidget(suiteIterationsSpinBox);
+        settingLayout->addWidget(new QLabel(HashWidget::tr("Sample Duration (ms):"), q_ptr));
+        settingLayout->addWidget(suiteDurationSpinBox);
+
+        auto *buttonLayout = new QHBoxLayout;
+        buttonLayout->setSpacing(20);
+        buttonLayout->addWidget(suiteStatusLabel);
+        buttonLayout->addStretch();
+        buttonLayout->addWidget(suiteExportButton);
+        buttonLayout->addWidget(suiteStartButton);
+
+        auto *groupBox = new QGroupBox(HashWidget::tr("Benchmark Suite"), q_ptr);
+        auto *layout = new QVBoxLayout(groupBox);
+        layout->addWidget(new QLabel(HashWidget::tr("Algorithms:"), q_ptr));
+        layout->addWidget(suiteAlgorithmList);
+        layout->addLayout(settingLayout);
+        layout->addLayout(buttonLayout);
+        layout->addWidget(suiteResultView);
+        return groupBox;
     }
 
     QGroupBox *createHashTestGroup() const
@@ -127,12 +305,33 @@ public:
     QPushButton *testButton;
     CpuBenchThread *cpuBenchThread;
 
+    QListWidget *suiteAlgorithmList;
+    QSpinBox *suiteIterationsSpinBox;
+    QSpinBox *suiteDurationSpinBox;
+    QLabel *suiteStatusLabel;
+    QPushButton *suiteStartButton;
+    QPushButton *suiteExportButton;
+    QTreeWidget *suiteResultView;
+    CpuBenchThread *suiteThread;
+    Utils::CpuBenchOptions suiteRunOptions;
+    QList<Utils::CpuBenchResult> suiteResults;
+    int suiteTotal = 0;
+
     QComboBox *hashComboBox;
     QPushButton *selectFileButton;
     QPushButton *calculateButton;
     QTextEdit *inputEdit;
     QTextEdit *outputEdit;
     HashThread *hashThread;
+
+    QListWidget *batchAlgorithmList;
+    QPlainTextEdit *batchInputEdit;
+    QPushButton *batchAddFilesButton;
+    QPushButton *batchAddDirectoryButton;
+    QPushButton *batchStartButton;
+    QLabel *batchStatusLabel;
+    QTreeWidget *batchResultView;
+    HashEngine *hashEngine;
 };
 
 HashWidget::HashWidget(QWidget *parent)
@@ -170,6 +369,91 @@ void HashWidget::onTestBenchFinished(double result)
     d_ptr->testButton->setEnabled(true);
 }
 
+void HashWidget::onSuiteStart()
+{
+    if (d_ptr->suiteThread->isRunning()) {
+        d_ptr->suiteThread->stop();
+        return;
+    }
+
+    auto options = d_ptr->suiteOptions();
+    if (options.algorithms.isEmpty()) {
+        Widgets::MessageBox::Warning(this,
+                                     tr("No algorithm selected!"),
+                                     Widgets::MessageBox::Close);
+        return;
+    }
+    d_ptr->suiteRunOptions = options;
+    d_ptr->suiteResults.clear();
+    d_ptr->suiteTotal = options.algorithms.size() * options.threadCounts.size()
+                        * options.bufferSizes.size();
+    d_ptr->suiteResultView->clear();
+    d_ptr->suiteStatusLabel->setText(tr("Running: 0/%1").arg(d_ptr->suiteTotal));
+    d_ptr->setSuiteRunning(true);
+    d_ptr->suiteThread->startSuite(options);
+}
+
+void HashWidget::onSuiteResult(const Utils::CpuBenchResult &result)
+{
+    d_ptr->suiteResults.append(result);
+
+    auto *item = new QTreeWidgetItem(d_ptr->suiteResultView);
+    item->setText(0, result.algorithmName());
+    item->setText(1, QString::number(result.threads));
+    item->setText(2, Utils::formatBytes(result.bufferSize, 0));
+    item->setText(3, QString::number(result.median, 'f', 2));
+    item->setText(4, QString::number(result.p95, 'f', 2));
+    item->setText(5, QString::number(result.min, 'f', 2));
+    item->setText(6, QString::number(result.scalingEfficiency * 100, 'f', 1) + '%');
+    for (int i = 1; i < item->columnCount(); ++i) {
+        item->setTextAlignment(i, Qt::AlignRight | Qt::AlignVCenter);
+    }
+    d_ptr->suiteResultView->scrollToItem(item);
+
+    d_ptr->suiteStatusLabel->setText(
+        tr("Running: %1/%2").arg(d_ptr->suiteResults.size()).arg(d_ptr->suiteTotal));
+}
+
+void HashWidget::onSuiteFinished(const QList<Utils::CpuBenchResult> &results)
+{
+    d_ptr->suiteResults = results;
+    d_ptr->suiteStatusLabel->setText(results.size() == d_ptr->suiteTotal
+                                         ? tr("Finished: %1 results").arg(results.size())
+                                         : tr("Stopped: %1/%2 results")
+                                               .arg(results.size())
+                                               .arg(d_ptr->suiteTotal));
+    d_ptr->setSuiteRunning(false);
+}
+
+void HashWidget::onSuiteExport()
+{
+    auto path = QStandardPaths::standardLocations(QStandardPaths::DocumentsLocation)
+                    .value(0, QDir::homePath());
+    QString selectedFilter;
+    auto filePath = QFileDialog::getSaveFileName(this,
+                                                 tr("Export"),
+                                                 path + "/cpubench.json",
+                                                 tr("JSON (*.json);;CSV (*.csv)"),
+                                                 &selectedFilter);
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    const auto csv = filePath.endsWith(".csv", Qt::CaseInsensitive)
+                     || (!filePath.endsWith(".json", Qt::CaseInsensitive)
+                         && selectedFilter.startsWith("CSV"));
+    const auto data = csv ? Utils::cpuBenchResultsToCsv(d_ptr->suiteResults)
+                          : QJsonDocument(Utils::cpuBenchResultsToJson(d_ptr->suiteRunOptions,
+                                                                       d_ptr->suiteResults))
+                                .toJson();
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+        Widgets::MessageBox::Warning(this,
+                                     tr("Export failed: %1").arg(file.errorString()),
+                                     Widgets::MessageBox::Close);
+    }
+}
+
 void HashWidget::onSelectFile()
 {
     auto path = QStandardPaths::standardLocations(QStandardPaths::DocumentsLocation)
@@ -205,6 +489,96 @@ void HashWidget::onHashFinished(const QString &result)
     d_ptr->calculateButton->setText(tr("Calculate"));
 }
 
+void HashWidget::onBatchAddFiles()
+{
+    auto path = QStandardPaths::standardLocations(QStandardPaths::DocumentsLocation)
+                    .value(0, QDir::homePath());
+    d_ptr->appendBatchInput(QFileDialog::getOpenFileNames(this, tr("Add Files"), path));
+}
+
+void HashWidget::onBatchAddDirectory()
+{
+    auto path = QStandardPaths::standardLocations(QStandardPaths::DocumentsLocation)
+                    .value(0, QDir::homePath());
+    auto dirPath = QFileDialog::getExistingDirectory(this, tr("Add Directory"), path);
+    if (!dirPath.isEmpty()) {
+        d_ptr->appendBatchInput({dirPath});
+    }
+}
+
+void HashWidget::onBatchStart()
+{
+    if (d_ptr->hashEngine->isRunning()) {
+        d_ptr->hashEngine->stop();
+        return;
+    }
+
+    QStringList paths;
+    const auto lines = d_ptr->batchInputEdit->toPlainText().split('\n', Qt::SkipEmptyParts);
+    for (const auto &line : lines) {
+        const auto path = QDir::fromNativeSeparators(line.trimmed());
+        if (!path.isEmpty()) {
+            paths.append(path);
+        }
+    }
+    if (paths.isEmpty()) {
+        Widgets::MessageBox::Warning(this, tr("Input is empty!"), Widgets::MessageBox::Close);
+        return;
+    }
+    const auto algorithms = d_ptr->checkedBatchAlgorithms();
+    if (algorithms.isEmpty()) {
+        Widgets::MessageBox::Warning(this,
+                                     tr("No algorithm selected!"),
+                                     Widgets::MessageBox::Close);
+        return;
+    }
+
+    QStringList headers{tr("File"), tr("Size")};
+    auto metaEnums = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (const auto algorithm : algorithms) {
+        headers.append(metaEnums.valueToKey(algorithm));
+    }
+    d_ptr->batchResultView->clear();
+    d_ptr->batchResultView->setColumnCount(headers.size());
+    d_ptr->batchResultView->setHeaderLabels(headers);
+
+    if (d_ptr->hashEngine->start(paths, algorithms)) {
+        d_ptr->setBatchRunning(true);
+    }
+}
+
+void HashWidget::onBatchFileFinished(const HashEngine::FileResult &result)
+{
+    auto *item = new QTreeWidgetItem(d_ptr->batchResultView);
+    item->setText(0, QDir::toNativeSeparators(result.filePath));
+    item->setToolTip(0, item->text(0));
+    item->setText(1, Utils::formatBytes(result.size));
+    if (!result.error.isEmpty()) {
+        item->setText(2, result.error);
+        return;
+    }
+    for (int i = 0; i < result.hashes.size(); ++i) {
+        item->setText(i + 2, QString::fromLatin1(result.hashes.at(i)));
+    }
+}
+
+void HashWidget::onBatchProgress(const HashEngine::Progress &progress)
+{
+    d_ptr->batchStatusLabel->setText(tr("Files: %1/%2%3 Data: %4/%5 Speed: %6 MB/s")
+                                         .arg(progress.filesDone)
+                                         .arg(progress.filesTotal)
+                                         .arg(progress.enumerating ? "+" : "")
+                                         .arg(Utils::formatBytes(progress.bytesDone),
+                                              Utils::formatBytes(progress.bytesTotal))
+                                         .arg(progress.throughput(), 0, 'f', 2));
+}
+
+void HashWidget::onBatchFinished(const HashEngine::Progress &progress)
+{
+    onBatchProgress(progress);
+    d_ptr->setBatchRunning(false);
+}
+
 void HashWidget::buildConnect()
 {
     connect(d_ptr->testButton, &QPushButton::clicked, this, &HashWidget::onTestHash);
@@ -213,9 +587,33 @@ void HashWidget::buildConnect()
             this,
             &HashWidget::onTestBenchFinished);
 
+    connect(d_ptr->suiteStartButton, &QPushButton::clicked, this, &HashWidget::onSuiteStart);
+    connect(d_ptr->suiteExportButton, &QPushButton::clicked, this, &HashWidget::onSuiteExport);
+    connect(d_ptr->suiteThread,
+            &CpuBenchThread::suiteResultReady,
+            this,
+            &HashWidget::onSuiteResult);
+    connect(d_ptr->suiteThread,
+            &CpuBenchThread::suiteFinished,
+            this,
+            &HashWidget::onSuiteFinished);
+
     connect(d_ptr->selectFileButton, &QPushButton::clicked, this, &HashWidget::onSelectFile);
     connect(d_ptr->calculateButton, &QPushButton::clicked, this, &HashWidget::onCalculate);
     connect(d_ptr->hashThread, &HashThread::hashFinished, this, &HashWidget::onHashFinished);
+
+    connect(d_ptr->batchAddFilesButton, &QPushButton::clicked, this, &HashWidget::onBatchAddFiles);
+    connect(d_ptr->batchAddDirectoryButton,
+            &QPushButton::clicked,
+            this,
+            &HashWidget::onBatchAddDirectory);
+    connect(d_ptr->batchStartButton, &QPushButton::clicked, this, &HashWidget::onBatchStart);
+    connect(d_ptr->hashEngine,
+            &HashEngine::fileFinished,
+            this,
+            &HashWidget::onBatchFileFinished);
+    connect(d_ptr->hashEngine, &HashEngine::progressChanged, this, &HashWidget::onBatchProgress);
+    connect(d_ptr->hashEngine, &HashEngine::finished, this, &HashWidget::onBatchFinished);
 }
 
 } // namespace Plugin
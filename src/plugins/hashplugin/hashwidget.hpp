@@ -1,5 +1,9 @@
 #pragma once
 
+#include "hashengine.hpp"
+
+#include <utils/cpubench.hpp>
+
 #include <QWidget>
 
 namespace Plugin {
@@ -14,9 +18,19 @@ public:
 private slots:
     void onTestHash();
     void onTestBenchFinished(double result); // MB/s
+    void onSuiteStart();
+    void onSuiteResult(const Utils::CpuBenchResult &result);
+    void onSuiteFinished(const QList<Utils::CpuBenchResult> &results);
+    void onSuiteExport();
     void onSelectFile();
     void onCalculate();
     void onHashFinished(const QString &result);
+    void onBatchAddFiles();
+    void onBatchAddDirectory();
+    void onBatchStart();
+    void onBatchFileFinished(const Plugin::HashEngine::FileResult &result);
+    void onBatchProgress(const Plugin::HashEngine::Progress &progress);
+    void onBatchFinished(const Plugin::HashEngine::Progress &progress);
 
 private:
     void buildConnect();
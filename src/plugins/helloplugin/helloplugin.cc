@@ -12,8 +12,9 @@ class HelloPluginWidget : public Core::CoreWidget
     Q_OBJECT
 public:
     explicit HelloPluginWidget(QObject *parent = nullptr)
+        : Core::CoreWidget(parent)
     {
-        setWidget(new HelloWidget);
+        setWidgetFactory([] { return new HelloWidget; }, true);
         setButton(new QPushButton(tr("Hello")), Core::CoreWidget::Main);
     }
 };
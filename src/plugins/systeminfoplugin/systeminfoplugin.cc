@@ -12,8 +12,9 @@ class SystemInfoPluginWidget : public Core::CoreWidget
     Q_OBJECT
 public:
     explicit SystemInfoPluginWidget(QObject *parent = nullptr)
+        : Core::CoreWidget(parent)
     {
-        setWidget(new SystemInfoWidget);
+        setWidgetFactory([] { return new SystemInfoWidget; }, true);
         setButton(new QPushButton(tr("System Info")), Core::CoreWidget::Help);
     }
 };
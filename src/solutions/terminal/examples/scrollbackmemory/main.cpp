@@ -0,0 +1,118 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0+ OR GPL-3.0 WITH Qt-GPL-exception-1.0
+
+// Memory benchmark for Scrollback lines.
+//
+// Pushes typical terminal output into a Scrollback and prints the bytes per line of the
+// compact line format next to the previous format, which kept a full VTermScreenCell per
+// column. Also checks that every line expands back into the cells it was built from.
+
+#include "../../scrollback.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace TerminalSolution;
+
+static const int cols = 160;
+static const int lineCount = 100000;
+
+static VTermScreenCell defaultCell()
+{
+    VTermScreenCell cell;
+    memset(&cell, 0, sizeof(cell));
+    cell.width = 1;
+    vterm_color_indexed(&cell.fg, 16);
+    vterm_color_indexed(&cell.bg, 17);
+    return cell;
+}
+
+static void setText(std::vector<VTermScreenCell> &cells, int col, const char *text)
+{
+    for (; *text && col < int(cells.size()); ++text, ++col)
+        cells[col].chars[0] = uint32_t(*text);
+}
+
+static std::vector<VTermScreenCell> asciiLine(int n)
+{
+    std::vector<VTermScreenCell> cells(cols, defaultCell());
+    char text[cols];
+    snprintf(text, sizeof(text),
+             "[%d/%d] Building CXX object src/plugins/core/CMakeFiles/core.dir/file%d.cpp.o",
+             n % 1000, 1000, n);
+    setText(cells, 0, text);
+    return cells;
+}
+
+static std::vector<VTermScreenCell> coloredLine(int n)
+{
+    std::vector<VTermScreenCell> cells = asciiLine(n);
+    setText(cells, 0, "error: ");
+    for (int i = 0; i < 6; ++i) {
+        cells[i].attrs.bold = 1;
+        vterm_color_indexed(&cells[i].fg, 1);
+    }
+    for (int i = 40; i < 52; ++i)
+        vterm_color_indexed(&cells[i].fg, 2);
+    return cells;
+}
+
+static std::vector<VTermScreenCell> wideLine(int n)
+{
+    std::vector<VTermScreenCell> cells(cols, defaultCell());
+    for (int i = 0; i + 1 < 80; i += 2) {
+        cells[i].chars[0] = 0x4e00 + uint32_t((n + i) % 0x5000);
+        cells[i].width = 2;
+        cells[i + 1].chars[0] = 0xffffffff;
+    }
+    return cells;
+}
+
+static std::vector<VTermScreenCell> combiningLine(int n)
+{
+    std::vector<VTermScreenCell> cells = asciiLine(n);
+    cells[3].chars[1] = 0x0301;
+    cells[9].chars[1] = 0x0308;
+    return cells;
+}
+
+static bool run(const char *name, const std::function<std::vector<VTermScreenCell>(int)> &generate)
+{
+    Scrollback scrollback(lineCount);
+    std::vector<VTermScreenCell> expanded(cols);
+    bool ok = true;
+    for (int n = 0; n < lineCount; ++n) {
+        const std::vector<VTermScreenCell> cells = generate(n);
+        scrollback.emplace(cols, cells.data());
+        if (n % 1000 == 0) {
+            memset(expanded.data(), 0, expanded.size() * sizeof(VTermScreenCell));
+            scrollback.line(0).expandTo(expanded.data(), cols);
+            ok &= memcmp(expanded.data(), cells.data(), cols * sizeof(VTermScreenCell)) == 0;
+        }
+    }
+
+    // What a line used to take: the Line object plus a VTermScreenCell per column.
+    const double before = sizeof(int) + sizeof(void *) + cols * sizeof(VTermScreenCell);
+    const double after = double(scrollback.memoryUsage()) / scrollback.size();
+    printf("%-12s %12.0f %12.0f %10.1fx %s\n",
+           name,
+           before,
+           after,
+           before / after,
+           ok ? "" : "MISMATCH");
+    return ok;
+}
+
+int main()
+{
+    printf("%d columns, %d lines\n", cols, lineCount);
+    printf("%-12s %12s %12s %11s\n", "content", "bytes/line", "compact", "ratio");
+    bool ok = true;
+    ok &= run("ascii", asciiLine);
+    ok &= run("colored", coloredLine);
+    ok &= run("combining", combiningLine);
+    ok &= run("wide", wideLine);
+    return ok ? 0 : 1;
+}
@@ -4,58 +4,539 @@
 
 #include "scrollback.h"
 
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryFile>
+
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <future>
+#include <stdexcept>
 
 namespace TerminalSolution {
 
+// Enough for every row of any sensible viewport plus the rows a selection or search
+// touches around it.
+constexpr size_t maxExpandedLines = 512;
+
+// Lines are moved to the swap file in blocks of this many lines, and at least that many
+// always stay in memory.
+constexpr size_t spillBlockLines = 1024;
+constexpr size_t maxPagedBlocks = 4;
+
+// The swap file is rewritten without the dropped blocks at its start once they take up
+// more than this and more than the blocks still in use.
+constexpr qint64 minCompactBytes = 16 * 1024 * 1024;
+constexpr qint64 copyChunkBytes = 1024 * 1024;
+
+template<typename T>
+static void append(QByteArray &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static T take(const char *&data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+}
+
+static bool sameAttributes(const VTermScreenCell &a, const VTermScreenCell &b)
+{
+    // libvterm hands out zero-initialized cells, so comparing the raw bytes is fine. An
+    // indexed color may still carry stale rgb bytes, which only costs an extra run.
+    return memcmp(&a.attrs, &b.attrs, sizeof(a.attrs)) == 0
+           && memcmp(&a.fg, &b.fg, sizeof(a.fg)) == 0 && memcmp(&a.bg, &b.bg, sizeof(a.bg)) == 0;
+}
+
 Scrollback::Line::Line(int cols, const VTermScreenCell *cells)
     : m_cols(cols)
-    , m_cells(std::make_unique<VTermScreenCell[]>(cols))
 {
-    memcpy(m_cells.get(), cells, cols * sizeof(cells[0]));
+    bool latin1 = true;
+    bool singleWidth = true;
+    size_t combiningCount = 0;
+    size_t runCount = 0;
+    for (int i = 0; i < cols; ++i) {
+        const VTermScreenCell &cell = cells[i];
+        if (cell.chars[0] > 0xff)
+            latin1 = false;
+        if (cell.width != 1)
+            singleWidth = false;
+        if (cell.chars[0] != 0 && cell.chars[0] != 0xffffffff && cell.chars[1] != 0)
+            ++combiningCount;
+        if (i == 0 || !sameAttributes(cell, cells[i - 1]))
+            ++runCount;
+    }
+
+    if (latin1) {
+        m_latin1.reset(new uint8_t[cols]);
+        for (int i = 0; i < cols; ++i)
+            m_latin1[i] = static_cast<uint8_t>(cells[i].chars[0]);
+    } else {
+        m_codepoints.reset(new uint32_t[cols]);
+        for (int i = 0; i < cols; ++i)
+            m_codepoints[i] = cells[i].chars[0];
+    }
+
+    if (!singleWidth) {
+        m_widths.reset(new uint8_t[cols]);
+        for (int i = 0; i < cols; ++i)
+            m_widths[i] = static_cast<uint8_t>(cells[i].width);
+    }
+
+    m_combining.reserve(combiningCount);
+    m_runs.reserve(runCount);
+    for (int i = 0; i < cols; ++i) {
+        const VTermScreenCell &cell = cells[i];
+        if (cell.chars[0] != 0 && cell.chars[0] != 0xffffffff && cell.chars[1] != 0) {
+            Combining combining{i, {}};
+            for (int c = 1; c < VTERM_MAX_CHARS_PER_CELL && cell.chars[c] != 0; ++c)
+                combining.chars[c - 1] = cell.chars[c];
+            m_combining.push_back(combining);
+        }
+        if (i == 0 || !sameAttributes(cell, cells[i - 1]))
+            m_runs.push_back({i, cell.attrs, cell.fg, cell.bg});
+    }
+}
+
+Scrollback::Line::Line(int cols)
+    : m_cols(cols)
+{}
+
+void Scrollback::Line::serialize(QByteArray &out) const
+{
+    append(out, m_cols);
+    append(out, uint8_t((m_latin1 ? 1 : 0) | (m_widths ? 2 : 0)));
+    if (m_latin1)
+        out.append(reinterpret_cast<const char *>(m_latin1.get()), m_cols);
+    else
+        out.append(reinterpret_cast<const char *>(m_codepoints.get()), m_cols * sizeof(uint32_t));
+    if (m_widths)
+        out.append(reinterpret_cast<const char *>(m_widths.get()), m_cols);
+    append(out, uint32_t(m_combining.size()));
+    out.append(reinterpret_cast<const char *>(m_combining.data()),
+               m_combining.size() * sizeof(Combining));
+    append(out, uint32_t(m_runs.size()));
+    out.append(reinterpret_cast<const char *>(m_runs.data()), m_runs.size() * sizeof(AttributeRun));
+}
+
+Scrollback::Line Scrollback::Line::deserialize(const char *&data)
+{
+    Line line(take<int>(data));
+    const auto flags = take<uint8_t>(data);
+    if (flags & 1) {
+        line.m_latin1.reset(new uint8_t[line.m_cols]);
+        memcpy(line.m_latin1.get(), data, line.m_cols);
+        data += line.m_cols;
+    } else {
+        line.m_codepoints.reset(new uint32_t[line.m_cols]);
+        memcpy(line.m_codepoints.get(), data, line.m_cols * sizeof(uint32_t));
+        data += line.m_cols * sizeof(uint32_t);
+    }
+    if (flags & 2) {
+        line.m_widths.reset(new uint8_t[line.m_cols]);
+        memcpy(line.m_widths.get(), data, line.m_cols);
+        data += line.m_cols;
+    }
+    line.m_combining.resize(take<uint32_t>(data));
+    if (!line.m_combining.empty())
+        memcpy(line.m_combining.data(), data, line.m_combining.size() * sizeof(Combining));
+    data += line.m_combining.size() * sizeof(Combining);
+    line.m_runs.resize(take<uint32_t>(data));
+    if (!line.m_runs.empty())
+        memcpy(line.m_runs.data(), data, line.m_runs.size() * sizeof(AttributeRun));
+    data += line.m_runs.size() * sizeof(AttributeRun);
+    return line;
+}
+
+uint32_t Scrollback::Line::codepoint(int i) const
+{
+    assert(i >= 0 && i < m_cols);
+    return m_latin1 ? m_latin1[i] : m_codepoints[i];
+}
+
+void Scrollback::Line::chars(int i, uint32_t *chars) const
+{
+    memset(chars, 0, VTERM_MAX_CHARS_PER_CELL * sizeof(uint32_t));
+    chars[0] = codepoint(i);
+
+    if (m_combining.empty())
+        return;
+    const auto it = std::lower_bound(m_combining.begin(),
+                                     m_combining.end(),
+                                     i,
+                                     [](const Combining &c, int col) { return c.col < col; });
+    if (it != m_combining.end() && it->col == i)
+        memcpy(&chars[1], it->chars, sizeof(it->chars));
+}
+
+void Scrollback::Line::decodeCell(int i, const AttributeRun &run, VTermScreenCell *cell) const
+{
+    memset(cell, 0, sizeof(*cell));
+    chars(i, cell->chars);
+    cell->width = width(i);
+    cell->attrs = run.attrs;
+    cell->fg = run.fg;
+    cell->bg = run.bg;
+}
+
+void Scrollback::Line::expandTo(VTermScreenCell *cells, int count) const
+{
+    count = std::min(count, m_cols);
+    for (size_t r = 0; r < m_runs.size(); ++r) {
+        const int end = r + 1 < m_runs.size() ? m_runs[r + 1].start : m_cols;
+        for (int i = m_runs[r].start; i < std::min(end, count); ++i)
+            decodeCell(i, m_runs[r], &cells[i]);
+    }
+}
+
+void Scrollback::Line::expand() const
+{
+    if (m_expanded)
+        return;
+    m_expanded.reset(new VTermScreenCell[m_cols]);
+    expandTo(m_expanded.get(), m_cols);
 }
 
 const VTermScreenCell *Scrollback::Line::cell(int i) const
 {
     assert(i >= 0 && i < m_cols);
-    return &m_cells[i];
+    expand();
+    return &m_expanded[i];
+}
+
+size_t Scrollback::Line::memoryUsage() const
+{
+    return sizeof(*this) + (m_latin1 ? m_cols : m_cols * sizeof(uint32_t))
+           + (m_widths ? m_cols : 0) + m_combining.capacity() * sizeof(Combining)
+           + m_runs.capacity() * sizeof(AttributeRun);
 }
 
 Scrollback::Scrollback(size_t capacity)
     : m_capacity(capacity)
 {}
 
+Scrollback::~Scrollback() = default;
+
+const Scrollback::Line &Scrollback::line(size_t index) const
+{
+    const Line &line = compactLine(index);
+    if (!line.isExpanded() && line.cols() > 0) {
+        line.expand();
+        m_expandedLines.push_back(&line);
+        if (m_expandedLines.size() > maxExpandedLines) {
+            m_expandedLines.front()->releaseExpanded();
+            m_expandedLines.pop_front();
+        }
+    }
+    return line;
+}
+
+const Scrollback::Line &Scrollback::compactLine(size_t index) const
+{
+    if (index >= m_size)
+        throw std::out_of_range("Scrollback::line");
+
+    if (index < m_deque.size())
+        return m_deque[index];
+
+    const qint64 seq = m_nextSeq - 1 - qint64(index);
+    const auto it = std::upper_bound(m_spilled.begin(),
+                                     m_spilled.end(),
+                                     seq,
+                                     [](qint64 seq, const SpilledBlock &block) {
+                                         return seq < block.firstSeq;
+                                     });
+    assert(it != m_spilled.begin());
+    const SpilledBlock &block = *std::prev(it);
+    const PagedBlock &paged = pagedBlock(block);
+    const size_t position = size_t(block.lastSeq - seq);
+    if (position < paged.lines.size())
+        return paged.lines[position];
+
+    // The block could not be read back.
+    static const Line emptyLine(0, nullptr);
+    return emptyLine;
+}
+
+void Scrollback::forgetExpanded(const Line &line) const
+{
+    if (!line.isExpanded())
+        return;
+    const auto it = std::find(m_expandedLines.begin(), m_expandedLines.end(), &line);
+    if (it != m_expandedLines.end())
+        m_expandedLines.erase(it);
+}
+
+void Scrollback::forgetExpanded(const std::vector<Line> &lines) const
+{
+    if (lines.empty())
+        return;
+    const Line *first = lines.data();
+    const Line *last = first + lines.size();
+    m_expandedLines.erase(std::remove_if(m_expandedLines.begin(),
+                                         m_expandedLines.end(),
+                                         [first, last](const Line *line) {
+                                             return line >= first && line < last;
+                                         }),
+                          m_expandedLines.end());
+}
+
+void Scrollback::dropPagedBlock(qint64 lastSeq) const
+{
+    const auto it = std::find_if(m_pagedBlocks.begin(),
+                                 m_pagedBlocks.end(),
+                                 [lastSeq](const PagedBlock &paged) {
+                                     return paged.lastSeq == lastSeq;
+                                 });
+    if (it == m_pagedBlocks.end())
+        return;
+    forgetExpanded(it->lines);
+    m_pagedBlocks.erase(it);
+}
+
+std::vector<Scrollback::Line> Scrollback::readBlock(const SpilledBlock &block) const
+{
+    QByteArray data;
+    if (uchar *mapped = m_swapFile->map(block.offset, block.size)) {
+        data = qUncompress(mapped, block.size);
+        m_swapFile->unmap(mapped);
+    } else if (m_swapFile->seek(block.offset)) {
+        data = qUncompress(m_swapFile->read(block.size));
+    }
+    if (data.isEmpty())
+        qWarning() << "Cannot read scrollback block from" << m_swapFile->fileName();
+
+    std::vector<Line> lines;
+    lines.reserve(size_t(block.lastSeq - block.firstSeq + 1));
+    const char *current = data.constData();
+    const char *end = current + data.size();
+    while (current < end)
+        lines.push_back(Line::deserialize(current));
+    return lines;
+}
+
+const Scrollback::PagedBlock &Scrollback::pagedBlock(const SpilledBlock &block) const
+{
+    for (auto it = m_pagedBlocks.begin(); it != m_pagedBlocks.end(); ++it) {
+        if (it->lastSeq == block.lastSeq) {
+            m_pagedBlocks.splice(m_pagedBlocks.begin(), m_pagedBlocks, it);
+            return m_pagedBlocks.front();
+        }
+    }
+
+    m_pagedBlocks.push_front({block.lastSeq, readBlock(block)});
+    while (m_pagedBlocks.size() > maxPagedBlocks) {
+        forgetExpanded(m_pagedBlocks.back().lines);
+        m_pagedBlocks.pop_back();
+    }
+    return m_pagedBlocks.front();
+}
+
+void Scrollback::spill()
+{
+    if (!m_swapFile) {
+        m_swapFile = std::make_unique<QTemporaryFile>(QDir::tempPath()
+                                                      + "/terminal-scrollback-XXXXXX");
+        if (!m_swapFile->open()) {
+            qWarning() << "Cannot create scrollback swap file:" << m_swapFile->errorString();
+            m_swapFile.reset();
+            m_swapFailed = true;
+            return;
+        }
+    }
+
+    const size_t count = std::min(spillBlockLines, m_deque.size());
+    QByteArray data;
+    for (size_t i = m_deque.size() - count; i < m_deque.size(); ++i)
+        m_deque[i].serialize(data);
+    const QByteArray compressed = qCompress(data);
+
+    const qint64 offset = m_swapEnd;
+    if (!m_swapFile->seek(offset) || m_swapFile->write(compressed) != compressed.size()
+        || !m_swapFile->flush()) {
+        qWarning() << "Cannot write scrollback swap file:" << m_swapFile->errorString();
+        m_swapFailed = true;
+        return;
+    }
+
+    m_swapEnd = offset + compressed.size();
+
+    const qint64 firstSeq = m_nextSeq - qint64(m_deque.size());
+    m_spilled.push_back({firstSeq, firstSeq + qint64(count) - 1, offset, compressed.size()});
+    for (size_t i = 0; i < count; ++i) {
+        forgetExpanded(m_deque.back());
+        m_dequeBytes -= m_deque.back().memoryUsage();
+        m_deque.pop_back();
+    }
+}
+
+void Scrollback::pageInNewestBlock()
+{
+    const SpilledBlock block = m_spilled.back();
+    std::vector<Line> lines = readBlock(block);
+    dropPagedBlock(block.lastSeq);
+    m_spilled.pop_back();
+    if (m_spilled.empty()) {
+        m_swapFile.reset();
+        m_swapEnd = 0;
+    } else {
+        // The newest block is at the end of the file, the next spill reuses its space.
+        m_swapEnd = block.offset;
+        m_swapFile->resize(m_swapEnd);
+    }
+
+    const size_t count = size_t(block.lastSeq - block.firstSeq + 1);
+    for (size_t i = 0; i < count; ++i) {
+        m_deque.push_back(i < lines.size() ? std::move(lines[i]) : Line(0, nullptr));
+        m_dequeBytes += m_deque.back().memoryUsage();
+    }
+}
+
+void Scrollback::compactSwapFile()
+{
+    const qint64 start = m_spilled.front().offset;
+    auto file = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/terminal-scrollback-XXXXXX");
+    if (!file->open() || !m_swapFile->seek(start)) {
+        qWarning() << "Cannot compact scrollback swap file:" << file->errorString();
+        return;
+    }
+    for (qint64 remaining = m_swapEnd - start; remaining > 0;) {
+        const QByteArray chunk = m_swapFile->read(std::min(remaining, copyChunkBytes));
+        if (chunk.isEmpty() || file->write(chunk) != chunk.size()) {
+            qWarning() << "Cannot compact scrollback swap file:" << file->errorString();
+            return;
+        }
+        remaining -= chunk.size();
+    }
+    if (!file->flush()) {
+        qWarning() << "Cannot compact scrollback swap file:" << file->errorString();
+        return;
+    }
+
+    for (SpilledBlock &block : m_spilled)
+        block.offset -= start;
+    m_swapEnd -= start;
+    m_swapFile = std::move(file);
+}
+
+void Scrollback::removeOldest()
+{
+    if (!m_spilled.empty()) {
+        // Spilled lines are stored newest first, so the oldest one is simply cut off.
+        SpilledBlock &oldest = m_spilled.front();
+        if (++oldest.firstSeq > oldest.lastSeq) {
+            dropPagedBlock(oldest.lastSeq);
+            m_spilled.pop_front();
+            if (m_spilled.empty()) {
+                m_swapFile.reset();
+                m_swapEnd = 0;
+            } else {
+                const qint64 unused = m_spilled.front().offset;
+                if (unused > minCompactBytes && unused > m_swapEnd - unused)
+                    compactSwapFile();
+            }
+        }
+    } else {
+        forgetExpanded(m_deque.back());
+        m_dequeBytes -= m_deque.back().memoryUsage();
+        m_deque.pop_back();
+    }
+    --m_size;
+}
+
 void Scrollback::emplace(int cols, const VTermScreenCell *cells)
 {
     m_deque.emplace_front(cols, cells);
-    while (m_deque.size() > m_capacity) {
-        m_deque.pop_back();
+    m_dequeBytes += m_deque.front().memoryUsage();
+    ++m_size;
+    ++m_nextSeq;
+    while (m_size > m_capacity)
+        removeOldest();
+
+    if (m_memoryLimit > 0 && qint64(m_dequeBytes) > m_memoryLimit && !m_swapFailed
+        && m_deque.size() > 2 * spillBlockLines) {
+        spill();
     }
 }
 
 void Scrollback::popto(int cols, VTermScreenCell *cells)
 {
+    if (m_deque.empty())
+        pageInNewestBlock();
+
     const Line &sbl = m_deque.front();
 
     int ncells = cols;
     if (ncells > sbl.cols())
         ncells = sbl.cols();
 
-    memcpy(cells, sbl.cells(), sizeof(cells[0]) * ncells);
+    sbl.expandTo(cells, ncells);
+
+    // Placeholder lines of swap blocks that could not be read have no cells to copy from.
+    VTermColor bg;
+    if (ncells > 0) {
+        bg = cells[ncells - 1].bg;
+    } else {
+        memset(&bg, 0, sizeof(bg));
+        bg.type = VTERM_COLOR_DEFAULT_BG;
+    }
+
     for (size_t i = ncells; i < static_cast<size_t>(cols); ++i) {
         cells[i].chars[0] = '\0';
         cells[i].width = 1;
-        cells[i].bg = cells[ncells - 1].bg;
+        cells[i].bg = bg;
     }
 
+    forgetExpanded(sbl);
+    m_dequeBytes -= sbl.memoryUsage();
     m_deque.pop_front();
+    --m_size;
+    --m_nextSeq;
 }
 
 void Scrollback::clear()
 {
+    m_expandedLines.clear();
     m_deque.clear();
+    m_dequeBytes = 0;
+    m_pagedBlocks.clear();
+    m_spilled.clear();
+    m_swapFile.reset();
+    m_swapEnd = 0;
+    m_swapFailed = false;
+    m_size = 0;
+    m_nextSeq = 0;
+}
+
+void Scrollback::setMemoryLimit(qint64 bytes)
+{
+    m_memoryLimit = bytes;
+    while (m_memoryLimit > 0 && qint64(m_dequeBytes) > m_memoryLimit && !m_swapFailed
+           && m_deque.size() > 2 * spillBlockLines) {
+        spill();
+    }
+}
+
+int Scrollback::spilledLineCount() const
+{
+    return static_cast<int>(m_size - m_deque.size());
+}
+
+size_t Scrollback::memoryUsage() const
+{
+    size_t result = sizeof(*this) + m_dequeBytes;
+    for (const PagedBlock &paged : m_pagedBlocks) {
+        for (const Line &line : paged.lines)
+            result += line.memoryUsage();
+    }
+    for (const Line *line : m_expandedLines)
+        result += line->cols() * sizeof(VTermScreenCell);
+    return result;
 }
 
 } // namespace TerminalSolution
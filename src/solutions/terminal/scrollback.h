@@ -8,16 +8,26 @@
 
 #include <deque>
 #include <future>
+#include <list>
 #include <memory>
+#include <vector>
 
 #include <QFont>
 #include <QTextLayout>
 
+QT_BEGIN_NAMESPACE
+class QTemporaryFile;
+QT_END_NAMESPACE
+
 namespace TerminalSolution {
 
 class Scrollback
 {
 public:
+    // A scrolled-off line in compact form: one codepoint per column (one byte per column
+    // if the line is Latin-1), the rare combining characters and wide cells on the side,
+    // and the attributes as runs of equal cells. Lines are only expanded back into
+    // VTermScreenCells when cell() is used, i.e. for the rows that are actually looked at.
     class Line
     {
     public:
@@ -27,31 +37,124 @@ public:
 
         int cols() const { return m_cols; };
         const VTermScreenCell *cell(int i) const;
-        const VTermScreenCell *cells() const { return &m_cells[0]; };
+
+        // Access to column i without expanding the line.
+        uint32_t codepoint(int i) const;
+        void chars(int i, uint32_t *chars) const; // VTERM_MAX_CHARS_PER_CELL entries
+        int width(int i) const { return m_widths ? m_widths[i] : 1; }
+        void expandTo(VTermScreenCell *cells, int count) const;
+
+        bool isLatin1() const { return m_latin1 != nullptr; }
+        void expand() const;
+        bool isExpanded() const { return m_expanded != nullptr; }
+        void releaseExpanded() const { m_expanded.reset(); }
+
+        // Heap and object bytes used by this line, not counting the expanded cells.
+        size_t memoryUsage() const;
+
+        void serialize(QByteArray &out) const;
+        static Line deserialize(const char *&data);
 
     private:
+        explicit Line(int cols);
+
+        struct AttributeRun
+        {
+            int start;
+            VTermScreenCellAttrs attrs;
+            VTermColor fg;
+            VTermColor bg;
+        };
+
+        struct Combining
+        {
+            int col;
+            uint32_t chars[VTERM_MAX_CHARS_PER_CELL - 1];
+        };
+
+        void decodeCell(int i, const AttributeRun &run, VTermScreenCell *cell) const;
+
         int m_cols;
-        std::unique_ptr<VTermScreenCell[]> m_cells;
+        std::unique_ptr<uint8_t[]> m_latin1;
+        std::unique_ptr<uint32_t[]> m_codepoints;
+        std::unique_ptr<uint8_t[]> m_widths; // Only if a cell is not one column wide.
+        std::vector<Combining> m_combining;  // Sorted by column.
+        std::vector<AttributeRun> m_runs;    // Sorted by start, first one starts at 0.
+        mutable std::unique_ptr<VTermScreenCell[]> m_expanded;
     };
 
 public:
     Scrollback(size_t capacity);
     Scrollback() = delete;
+    ~Scrollback();
 
     int capacity() const { return static_cast<int>(m_capacity); };
-    int size() const { return static_cast<int>(m_deque.size()); };
+    int size() const { return static_cast<int>(m_size); };
 
-    const Line &line(size_t index) const { return m_deque.at(index); };
-    const std::deque<Line> &lines() const { return m_deque; };
+    // Index 0 is the newest line. Expands the line, and pages it in if it was spilled to
+    // disk; only the most recently used lines and blocks stay in memory.
+    const Line &line(size_t index) const;
+    // Like line(), but does not expand the line. For walking many lines.
+    const Line &compactLine(size_t index) const;
 
     void emplace(int cols, const VTermScreenCell *cells);
     void popto(int cols, VTermScreenCell *cells);
 
     void clear();
 
+    // Once the lines in memory use more than this many bytes, the oldest ones are
+    // compressed in blocks and moved to a temporary file. 0 keeps everything in memory.
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const { return m_memoryLimit; }
+
+    size_t memoryUsage() const;
+    int spilledLineCount() const;
+
 private:
+    // A block of lines in the swap file, stored newest first. Lines are numbered from
+    // the oldest line ever pushed (see m_nextSeq), so trimming the oldest lines of a
+    // block only moves firstSeq.
+    struct SpilledBlock
+    {
+        qint64 firstSeq;
+        qint64 lastSeq;
+        qint64 offset;
+        qint64 size;
+    };
+
+    struct PagedBlock
+    {
+        qint64 lastSeq;
+        std::vector<Line> lines;
+    };
+
+    void forgetExpanded(const Line &line) const;
+    void forgetExpanded(const std::vector<Line> &lines) const;
+    void dropPagedBlock(qint64 lastSeq) const;
+    void removeOldest();
+    void spill();
+    std::vector<Line> readBlock(const SpilledBlock &block) const;
+    const PagedBlock &pagedBlock(const SpilledBlock &block) const;
+    void pageInNewestBlock();
+    void compactSwapFile();
+
     size_t m_capacity;
-    std::deque<Line> m_deque;
+    size_t m_size = 0;
+    qint64 m_nextSeq = 0;
+
+    std::deque<Line> m_deque; // The newest lines, newest first.
+    size_t m_dequeBytes = 0;
+    qint64 m_memoryLimit = 0;
+
+    std::deque<SpilledBlock> m_spilled; // Oldest first.
+    std::unique_ptr<QTemporaryFile> m_swapFile;
+    // Blocks are stored in the order of m_spilled, so the bytes before the oldest block
+    // are unused and the file ends at the newest one.
+    qint64 m_swapEnd = 0;
+    bool m_swapFailed = false;
+    mutable std::list<PagedBlock> m_pagedBlocks; // Most recently used first.
+
+    mutable std::deque<const Line *> m_expandedLines;
 };
 
 } // namespace TerminalSolution
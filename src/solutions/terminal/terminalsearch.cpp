@@ -0,0 +1,379 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0+ OR GPL-3.0 WITH Qt-GPL-exception-1.0
+
+#include "terminalsearch.h"
+#include "terminalsurface.h"
+
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <chrono>
+#include <climits>
+#include <deque>
+
+using namespace std::chrono_literals;
+
+namespace TerminalSolution {
+
+// Rows read and matched per worker job. Reading a chunk on the main thread takes about
+// a millisecond for typical line lengths.
+constexpr int chunkRows = 2048;
+
+// New output is collected for this long before the changed rows are searched again.
+constexpr std::chrono::milliseconds updateDelay = 100ms;
+
+namespace {
+
+struct RowText
+{
+    int row;
+    QString text;
+    QList<int> columns; // See TerminalSurface::rowText()
+};
+
+struct Range
+{
+    int first;
+    int last; // exclusive
+};
+
+QList<SearchHit> findInRows(const QPromise<QList<SearchHit>> &promise,
+                            const TerminalSearch::Query &query,
+                            const QRegularExpression &regExp,
+                            const QList<RowText> &rows,
+                            int width)
+{
+    QList<SearchHit> hits;
+    const Qt::CaseSensitivity cs = query.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    for (const RowText &row : rows) {
+        if (promise.isCanceled())
+            return {};
+
+        const auto addHit = [&](qsizetype start, qsizetype end) {
+            const int startColumn = row.columns.isEmpty() ? int(start) : row.columns.at(start);
+            const int endColumn = row.columns.isEmpty() ? int(end) : row.columns.at(end);
+            hits.append({row.row * width + startColumn, row.row * width + endColumn});
+        };
+
+        if (query.regularExpression) {
+            QRegularExpressionMatchIterator it = regExp.globalMatch(row.text);
+            while (it.hasNext()) {
+                const QRegularExpressionMatch match = it.next();
+                if (match.capturedLength() > 0)
+                    addHit(match.capturedStart(), match.capturedEnd());
+            }
+        } else {
+            qsizetype index = row.text.indexOf(query.text, 0, cs);
+            while (index >= 0) {
+                addHit(index, index + query.text.size());
+                index = row.text.indexOf(query.text, index + query.text.size(), cs);
+            }
+        }
+    }
+    return hits;
+}
+
+} // namespace
+
+class TerminalSearchPrivate
+{
+public:
+    TerminalSearchPrivate(TerminalSearch *q, TerminalSurface *surface)
+        : q(q)
+        , m_surface(surface)
+    {}
+
+    int height() const { return m_surface->fullSize().height(); }
+
+    void restart();
+    void queueRows(int first, int last, bool urgent);
+    void prioritizeViewport();
+    void markDirty(int firstRow);
+    void updateDirtyRows();
+    void scheduleNext();
+    void jobFinished();
+
+    TerminalSearch *q;
+    TerminalSurface *m_surface;
+
+    TerminalSearch::Query m_query;
+    QRegularExpression m_regExp;
+    QList<SearchHit> m_hits;
+
+    int m_viewportFirst{0};
+    int m_viewportRows{0};
+    int m_width{0};
+    int m_height{0};
+
+    std::deque<Range> m_pending;
+
+    QFutureWatcher<QList<SearchHit>> m_watcher;
+    Range m_running{0, 0};
+    bool m_runningStale{false};
+
+    int m_firstDirtyRow{INT_MAX};
+    QTimer m_updateTimer;
+};
+
+void TerminalSearchPrivate::restart()
+{
+    if (m_watcher.isRunning()) {
+        m_watcher.cancel();
+        m_runningStale = true;
+    }
+
+    const bool hadHits = !m_hits.isEmpty();
+    m_hits.clear();
+    m_pending.clear();
+    m_firstDirtyRow = INT_MAX;
+    m_updateTimer.stop();
+    m_width = m_surface->liveSize().width();
+    m_height = height();
+
+    if (m_query.regularExpression) {
+        m_regExp.setPattern(m_query.text);
+        m_regExp.setPatternOptions(m_query.caseSensitive
+                                       ? QRegularExpression::NoPatternOption
+                                       : QRegularExpression::CaseInsensitiveOption);
+    }
+
+    if (!m_query.text.isEmpty() && (!m_query.regularExpression || m_regExp.isValid())) {
+        queueRows(0, m_height, false);
+        prioritizeViewport();
+    }
+
+    if (hadHits)
+        emit q->hitsChanged();
+    scheduleNext();
+}
+
+void TerminalSearchPrivate::queueRows(int first, int last, bool urgent)
+{
+    std::vector<Range> chunks;
+    for (int row = first; row < last; row += chunkRows)
+        chunks.push_back({row, qMin(last, row + chunkRows)});
+
+    if (urgent)
+        m_pending.insert(m_pending.begin(), chunks.begin(), chunks.end());
+    else
+        m_pending.insert(m_pending.end(), chunks.begin(), chunks.end());
+}
+
+void TerminalSearchPrivate::prioritizeViewport()
+{
+    // The viewport first, then the chunks closest to it, alternating below and above.
+    const int first = m_viewportFirst;
+    const int last = m_viewportFirst + m_viewportRows;
+    const auto distance = [first, last](const Range &range) {
+        if (range.first < last && range.last > first)
+            return 0;
+        return range.first >= last ? 2 * (range.first - last) + 1 : 2 * (first - range.last) + 2;
+    };
+
+    std::deque<Range> pending;
+    for (const Range &range : m_pending) {
+        const Range parts[] = {{range.first, qMin(range.last, first)},
+                               {qMax(range.first, first), qMin(range.last, last)},
+                               {qMax(range.first, last), range.last}};
+        for (const Range &part : parts) {
+            if (part.first < part.last)
+                pending.push_back(part);
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&](const Range &a, const Range &b) {
+        return distance(a) < distance(b);
+    });
+    m_pending = std::move(pending);
+}
+
+void TerminalSearchPrivate::markDirty(int firstRow)
+{
+    if (m_query.text.isEmpty())
+        return;
+    m_firstDirtyRow = qMin(m_firstDirtyRow, qMax(0, firstRow));
+    // Not restarted on every change, so continuous output still gets searched.
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start();
+}
+
+void TerminalSearchPrivate::updateDirtyRows()
+{
+    const int firstRow = m_firstDirtyRow;
+    m_firstDirtyRow = INT_MAX;
+    if (firstRow >= m_height)
+        return;
+
+    // Drop what was found in the changed rows and everything that is still queued there.
+    const int firstPos = firstRow * m_width;
+    const auto firstHit = std::lower_bound(m_hits.begin(),
+                                           m_hits.end(),
+                                           firstPos,
+                                           [](const SearchHit &hit, int pos) {
+                                               return hit.start < pos;
+                                           });
+    const bool hitsRemoved = firstHit != m_hits.end();
+    m_hits.erase(firstHit, m_hits.end());
+
+    std::deque<Range> pending;
+    for (const Range &range : m_pending) {
+        if (range.first < firstRow)
+            pending.push_back({range.first, qMin(range.last, firstRow)});
+    }
+    m_pending = std::move(pending);
+
+    if (m_watcher.isRunning() && m_running.last > firstRow) {
+        m_runningStale = true;
+        if (m_running.first < firstRow)
+            queueRows(m_running.first, firstRow, true);
+    }
+
+    queueRows(firstRow, m_height, true);
+
+    if (hitsRemoved)
+        emit q->hitsChanged();
+    scheduleNext();
+}
+
+void TerminalSearchPrivate::scheduleNext()
+{
+    if (m_watcher.isRunning())
+        return;
+
+    if (m_pending.empty()) {
+        emit q->searchFinished();
+        return;
+    }
+
+    m_running = m_pending.front();
+    m_pending.pop_front();
+    m_runningStale = false;
+
+    QList<RowText> rows;
+    rows.reserve(m_running.last - m_running.first);
+    for (int row = m_running.first; row < m_running.last; ++row) {
+        RowText rowText{row, {}, {}};
+        rowText.text = m_surface->rowText(row, &rowText.columns);
+        if (!rowText.text.isEmpty())
+            rows.append(std::move(rowText));
+    }
+
+    auto promise = std::make_shared<QPromise<QList<SearchHit>>>();
+    promise->start();
+    m_watcher.setFuture(promise->future());
+    QThreadPool::globalInstance()->start(
+        [promise, query = m_query, regExp = m_regExp, rows = std::move(rows), width = m_width] {
+            promise->addResult(findInRows(*promise, query, regExp, rows, width));
+            promise->finish();
+        });
+}
+
+void TerminalSearchPrivate::jobFinished()
+{
+    if (!m_runningStale && !m_watcher.isCanceled() && m_watcher.future().resultCount() > 0) {
+        const QList<SearchHit> hits = m_watcher.result();
+        if (!hits.isEmpty()) {
+            // The rows of a job do not overlap any hits found so far.
+            const qsizetype index = std::lower_bound(m_hits.cbegin(),
+                                                     m_hits.cend(),
+                                                     hits.first().start,
+                                                     [](const SearchHit &hit, int pos) {
+                                                         return hit.start < pos;
+                                                     })
+                                    - m_hits.cbegin();
+            m_hits.insert(index, hits.size(), {});
+            std::copy(hits.cbegin(), hits.cend(), m_hits.begin() + index);
+            emit q->hitsChanged();
+        }
+    }
+    m_running = {0, 0};
+    scheduleNext();
+}
+
+TerminalSearch::TerminalSearch(TerminalSurface *surface, QObject *parent)
+    : QObject(parent)
+    , d(std::make_unique<TerminalSearchPrivate>(this, surface))
+{
+    d->m_width = surface->liveSize().width();
+    d->m_height = surface->fullSize().height();
+
+    d->m_updateTimer.setSingleShot(true);
+    d->m_updateTimer.setInterval(updateDelay);
+    connect(&d->m_updateTimer, &QTimer::timeout, this, [this] { d->updateDirtyRows(); });
+
+    connect(&d->m_watcher, &QFutureWatcherBase::finished, this, [this] { d->jobFinished(); });
+
+    connect(surface, &TerminalSurface::invalidated, this, [this](const QRect &rect) {
+        d->markDirty(rect.top());
+    });
+    connect(surface, &TerminalSurface::fullSizeChanged, this, [this](const QSize &size) {
+        if (d->m_query.text.isEmpty()) {
+            d->m_width = size.width();
+            d->m_height = size.height();
+            return;
+        }
+        if (size.width() != d->m_width || size.height() < d->m_height) {
+            d->restart();
+            return;
+        }
+        // Lines scrolled into the scrollback keep their rows, the rows of the screen
+        // moved up.
+        const int oldScreenTop = d->m_height - d->m_surface->liveSize().height();
+        d->m_height = size.height();
+        d->markDirty(oldScreenTop);
+    });
+    connect(surface, &TerminalSurface::altscreenChanged, this, [this] {
+        if (!d->m_query.text.isEmpty())
+            d->restart();
+    });
+    connect(surface, &TerminalSurface::cleared, this, [this] {
+        if (!d->m_query.text.isEmpty())
+            d->restart();
+    });
+}
+
+TerminalSearch::~TerminalSearch()
+{
+    if (d->m_watcher.isRunning()) {
+        d->m_watcher.cancel();
+        d->m_watcher.waitForFinished();
+    }
+}
+
+void TerminalSearch::setQuery(const Query &query)
+{
+    if (d->m_query == query)
+        return;
+    d->m_query = query;
+    d->restart();
+}
+
+TerminalSearch::Query TerminalSearch::query() const
+{
+    return d->m_query;
+}
+
+void TerminalSearch::setViewport(int firstRow, int rowCount)
+{
+    if (d->m_viewportFirst == firstRow && d->m_viewportRows == rowCount)
+        return;
+    d->m_viewportFirst = firstRow;
+    d->m_viewportRows = rowCount;
+    if (!d->m_pending.empty())
+        d->prioritizeViewport();
+}
+
+const QList<SearchHit> &TerminalSearch::hits() const
+{
+    return d->m_hits;
+}
+
+bool TerminalSearch::isSearching() const
+{
+    return d->m_watcher.isRunning() || !d->m_pending.empty() || d->m_updateTimer.isActive();
+}
+
+} // namespace TerminalSolution
@@ -0,0 +1,74 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0+ OR GPL-3.0 WITH Qt-GPL-exception-1.0
+
+#pragma once
+
+#include "terminal_global.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+namespace TerminalSolution {
+
+class TerminalSurface;
+class TerminalSearchPrivate;
+
+struct SearchHit
+{
+    int start{-1};
+    int end{-1};
+
+    bool operator!=(const SearchHit &other) const
+    {
+        return start != other.start || end != other.end;
+    }
+    bool operator==(const SearchHit &other) const { return !operator!=(other); }
+};
+
+// Searches the screen and the scrollback of a surface. The rows are read on the main
+// thread in chunks and matched on a worker thread, starting with the rows in the viewport.
+// New output only rescans the rows that changed. Matches do not span rows.
+class TERMINAL_EXPORT TerminalSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Query
+    {
+        QString text;
+        bool caseSensitive{false};
+        bool regularExpression{false};
+
+        bool operator==(const Query &other) const
+        {
+            return text == other.text && caseSensitive == other.caseSensitive
+                   && regularExpression == other.regularExpression;
+        }
+        bool operator!=(const Query &other) const { return !operator==(other); }
+    };
+
+    explicit TerminalSearch(TerminalSurface *surface, QObject *parent = nullptr);
+    ~TerminalSearch() override;
+
+    void setQuery(const Query &query);
+    Query query() const;
+
+    // Rows in this range are searched first.
+    void setViewport(int firstRow, int rowCount);
+
+    // Sorted by position; grows while the search is running.
+    const QList<SearchHit> &hits() const;
+    bool isSearching() const;
+
+signals:
+    void hitsChanged();
+    void searchFinished();
+
+private:
+    std::unique_ptr<TerminalSearchPrivate> d;
+};
+
+} // namespace TerminalSolution
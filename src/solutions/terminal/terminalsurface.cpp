@@ -23,6 +23,32 @@ QColor toQColor(const VTermColor &c)
 
 constexpr int batchFlushSize = 256;
 
+// The character of a cell, NFC normalized, or 0 for empty cells and the second half of
+// wide characters.
+static char32_t cellChar(const uint32_t *chars, int width)
+{
+    if (width == 0 || chars[0] == 0 || chars[0] == 0xffffffff)
+        return 0;
+
+    // A single character is already normalized, unless it has a canonical decomposition.
+    // Below U+0300 (ASCII, Latin-1, ...) such characters are composed in NFC as well.
+    if (chars[1] == 0
+        && (chars[0] < 0x300 || QChar::decompositionTag(chars[0]) != QChar::Canonical)) {
+        return chars[0];
+    }
+
+    int count = 1;
+    while (count < VTERM_MAX_CHARS_PER_CELL && chars[count] != 0)
+        ++count;
+    const QString s = QString::fromUcs4(reinterpret_cast<const char32_t *>(chars), count)
+                          .normalized(QString::NormalizationForm_C);
+    if (s.isEmpty())
+        return 0;
+    if (s.size() > 1 && s.at(0).isHighSurrogate() && s.at(1).isLowSurrogate())
+        return QChar::surrogateToUcs4(s.at(0), s.at(1));
+    return s.at(0).unicode();
+}
+
 struct TerminalSurfacePrivate
 {
     TerminalSurfacePrivate(TerminalSurface *surface, const QSize &initialGridSize)
@@ -399,6 +425,35 @@ struct TerminalSurfacePrivate
         return &refCell;
     }
 
+    // Calls f(x, chars, width) for the columns [first, last) of a row that have a cell.
+    // Scrollback lines are read in their compact form, without expanding them.
+    template<typename F>
+    void forEachCell(int row, int first, int last, const F &f)
+    {
+        if (row < 0 || row >= q->fullSize().height())
+            return;
+
+        const Scrollback::Line *line = nullptr;
+        int y = row;
+        if (!m_altscreen && row < m_scrollback->size())
+            line = &m_scrollback->compactLine((m_scrollback->size() - 1) - row);
+        else if (!m_altscreen)
+            y -= m_scrollback->size();
+
+        last = qMin(last, line ? qMin(liveSize().width(), line->cols()) : liveSize().width());
+        uint32_t chars[VTERM_MAX_CHARS_PER_CELL];
+        VTermScreenCell cell;
+        for (int x = qMax(0, first); x < last; ++x) {
+            if (line) {
+                line->chars(x, chars);
+                f(x, chars, line->width(x));
+            } else {
+                vterm_screen_get_cell(m_vtermScreen, VTermPos{y, x}, &cell);
+                f(x, cell.chars, int(cell.width));
+            }
+        }
+    }
+
     std::unique_ptr<VTerm, void (*)(VTerm *)> m_vterm;
     char buffer[256];
     VTermScreen *m_vtermScreen;
@@ -452,22 +507,120 @@ QSize TerminalSurface::fullSize() const
     return QSize{d->liveSize().width(), d->liveSize().height() + d->m_scrollback->size()};
 }
 
+void TerminalSurface::setScrollbackMemoryLimit(qint64 bytes)
+{
+    d->m_scrollback->setMemoryLimit(bytes);
+}
+
+qint64 TerminalSurface::scrollbackMemoryLimit() const
+{
+    return d->m_scrollback->memoryLimit();
+}
+
 std::u32string::value_type TerminalSurface::fetchCharAt(int x, int y) const
 {
-    const VTermScreenCell *cell = d->cellAt(x, y);
-    if (!cell)
+    if (x < 0 || x >= liveSize().width())
         return 0;
 
-    if (cell->width == 0)
-        return 0;
+    char32_t c = 0;
+    d->forEachCell(y, x, x + 1, [&c](int, const uint32_t *chars, int width) {
+        c = cellChar(chars, width);
+    });
+    return c;
+}
+
+std::u32string TerminalSurface::rowChars(int row, int firstColumn, int lastColumn) const
+{
+    if (lastColumn < 0 || lastColumn > liveSize().width())
+        lastColumn = liveSize().width();
+    firstColumn = qMax(0, firstColumn);
+    if (firstColumn >= lastColumn)
+        return {};
+
+    std::u32string result(lastColumn - firstColumn, 0);
+    d->forEachCell(row, firstColumn, lastColumn, [&](int x, const uint32_t *chars, int width) {
+        result[x - firstColumn] = cellChar(chars, width);
+    });
+    return result;
+}
+
+QString TerminalSurface::textRange(int start, int end) const
+{
+    const int width = liveSize().width();
+    const int size = fullSize().width() * fullSize().height();
+    start = qBound(0, start, size);
+    end = qBound(0, end, size);
+
+    QString text;
+    if (width <= 0 || start >= end)
+        return text;
+
+    bool previousWasZero = false;
+    for (int row = start / width; row * width < end; ++row) {
+        const int first = qMax(0, start - row * width);
+        const int last = qMin(width, end - row * width);
+        const std::u32string chars = rowChars(row, first, last);
+        for (int x = first; x < last; ++x) {
+            // Rows that end in an empty cell were not wrapped.
+            if (x == 0 && !text.isEmpty() && previousWasZero)
+                text.append(QLatin1Char('\n'));
+
+            const char32_t c = chars[x - first];
+            if (c != 0) {
+                previousWasZero = false;
+                text.append(QChar::fromUcs4(c));
+            } else {
+                previousWasZero = true;
+            }
+        }
+    }
+    return text;
+}
 
-    if (cell->chars[0] == 0xffffffff)
-        return 0;
+QString TerminalSurface::rowText(int row, QList<int> *columns) const
+{
+    QString text;
+    if (columns)
+        columns->clear();
+    if (row < 0 || row >= fullSize().height())
+        return text;
 
-    QString s = QString::fromUcs4(reinterpret_cast<const char32_t *>(cell->chars), 6)
-                    .normalized(QString::NormalizationForm_C);
-    const QList<uint> ucs4 = s.toUcs4();
-    return std::u32string(ucs4.begin(), ucs4.end()).front();
+    text.reserve(liveSize().width());
+    qsizetype textSize = 0;
+    int endColumn = 0;
+    d->forEachCell(row, 0, liveSize().width(), [&](int x, const uint32_t *chars, int width) {
+        // Second half of a wide character
+        if (chars[0] == 0xffffffff)
+            return;
+
+        if (chars[0] == 0) {
+            text.append(QLatin1Char(' '));
+            if (columns)
+                columns->append(x);
+            return;
+        }
+
+        for (int i = 0; i < VTERM_MAX_CHARS_PER_CELL && chars[i] != 0; ++i) {
+            const qsizetype before = text.size();
+            text.append(QChar::fromUcs4(chars[i]));
+            if (columns)
+                columns->insert(columns->size(), text.size() - before, x);
+        }
+        textSize = text.size();
+        endColumn = x + width;
+    });
+
+    text.truncate(textSize);
+    if (columns) {
+        columns->resize(textSize);
+        columns->append(endColumn);
+        bool identity = endColumn == textSize;
+        for (qsizetype i = 0; identity && i < textSize; ++i)
+            identity = columns->at(i) == i;
+        if (identity)
+            columns->clear();
+    }
+    return text;
 }
 
 TerminalCell TerminalSurface::fetchCell(int x, int y) const
@@ -74,11 +74,25 @@ public:
 
     TerminalCell fetchCell(int x, int y) const;
     std::u32string::value_type fetchCharAt(int x, int y) const;
+    // fetchCharAt() for the columns [firstColumn, lastColumn) of a row. A negative
+    // lastColumn means up to the end of the row.
+    std::u32string rowChars(int row, int firstColumn = 0, int lastColumn = -1) const;
+    // The text of the cells [start, end) as copied from a selection: empty cells are left out
+    // and a line break is added before a row if the previous one ended with an empty cell.
+    QString textRange(int start, int end) const;
+    // The text of a row without trailing empty cells. If columns is given, it receives the
+    // column of each UTF-16 code unit plus the column after the text, or stays empty if
+    // code unit i is in column i.
+    QString rowText(int row, QList<int> *columns = nullptr) const;
     int cellWidthAt(int x, int y) const;
 
     QSize liveSize() const;
     QSize fullSize() const;
 
+    // See Scrollback::setMemoryLimit()
+    void setScrollbackMemoryLimit(qint64 bytes);
+    qint64 scrollbackMemoryLimit() const;
+
     QPoint posToGrid(int pos) const;
     int gridToPos(QPoint gridPos) const;
 
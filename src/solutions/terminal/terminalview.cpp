@@ -20,6 +20,7 @@
 #include <QPaintEvent>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPixmap>
 #include <QPixmapCache>
 #include <QRawFont>
 #include <QRegularExpression>
@@ -60,9 +61,23 @@ public:
 
     std::optional<TerminalView::Selection> m_selection;
     std::unique_ptr<TerminalSurface> m_surface;
+    std::unique_ptr<TerminalSearch> m_search;
 
     QSizeF m_cellSize;
 
+    // Rows are painted once into a pixmap and then only blitted, until libvterm reports
+    // them as damaged or the selection, link or search hits in them change. The cursor
+    // and the preedit text are painted on top. Rows with glyphs taller than a cell
+    // have no pixmap and are painted directly, so these glyphs are not clipped.
+    struct RowImage
+    {
+        QPixmap pixmap;
+        QSize pixelSize;
+        QList<int> overlays; // See TerminalView::rowOverlays()
+    };
+    QCache<int, RowImage> m_rowCache;
+    int m_rowCacheHeight{0};
+
     bool m_ignoreScroll{false};
 
     QString m_preEditString;
@@ -95,6 +110,7 @@ public:
     bool m_allowBlinkingCursor{true};
     bool m_allowMouseTracking{true};
     bool m_passwordModeActive{false};
+    qint64 m_scrollbackMemoryLimit{64 * 1024 * 1024};
 
     SurfaceIntegration *m_surfaceIntegration{nullptr};
 };
@@ -149,6 +165,10 @@ TerminalView::TerminalView(QWidget *parent)
 
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
 
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        d->m_search->setViewport(value, d->m_surface->liveSize().height());
+    });
+
     connect(&d->m_flushDelayTimer, &QTimer::timeout, this, [this] { flushVTerm(true); });
     connect(&d->m_updateTimer, &QTimer::timeout, this, &TerminalView::scheduleViewportUpdate);
 
@@ -174,20 +194,52 @@ TerminalSurface *TerminalView::surface() const
     return d->m_surface.get();
 }
 
+TerminalSearch *TerminalView::search() const
+{
+    return d->m_search.get();
+}
+
+const QList<SearchHit> &TerminalView::searchHits() const
+{
+    return d->m_search->hits();
+}
+
 void TerminalView::setupSurface()
 {
+    // The search belongs to the old surface.
+    const TerminalSearch::Query query = d->m_search ? d->m_search->query()
+                                                    : TerminalSearch::Query();
+    d->m_search.reset();
+    d->m_rowCache.clear();
     d->m_surface = std::make_unique<TerminalSurface>(QSize{80, 60});
+    d->m_rowCacheHeight = d->m_surface->fullSize().height();
+    d->m_surface->setScrollbackMemoryLimit(d->m_scrollbackMemoryLimit);
     connect(d->m_surface.get(), &TerminalSurface::cleared, this, &TerminalView::cleared);
 
+    d->m_search = std::make_unique<TerminalSearch>(d->m_surface.get());
+    d->m_search->setViewport(verticalScrollBar()->value(), d->m_surface->liveSize().height());
+    d->m_search->setQuery(query);
+    connect(d->m_search.get(), &TerminalSearch::hitsChanged, this, [this] { updateViewport(); });
+
     if (d->m_surfaceIntegration)
         d->m_surface->setSurfaceIntegration(d->m_surfaceIntegration);
 
     d->m_surface->setWriteToPty([this](const QByteArray &data) { return writeToPty(data); });
 
-    connect(d->m_surface.get(), &TerminalSurface::fullSizeChanged, this, [this] {
-        updateScrollBars();
-    });
+    connect(
+        d->m_surface.get(),
+        &TerminalSurface::fullSizeChanged,
+        this,
+        [this](const QSize &size) {
+            // Lines pushed into the scrollback keep their row, anything else moves rows.
+            if (size.height() < d->m_rowCacheHeight)
+                d->m_rowCache.clear();
+            d->m_rowCacheHeight = size.height();
+            updateScrollBars();
+        });
     connect(d->m_surface.get(), &TerminalSurface::invalidated, this, [this](const QRect &rect) {
+        for (int row = rect.top(); row <= rect.bottom(); ++row)
+            d->m_rowCache.remove(row);
         setSelection(std::nullopt);
         updateViewportRect(gridToViewport(rect));
         if (verticalScrollBar()->value() == verticalScrollBar()->maximum())
@@ -215,6 +267,8 @@ void TerminalView::setupSurface()
             configBlinkTimer();
         });
     connect(d->m_surface.get(), &TerminalSurface::altscreenChanged, this, [this] {
+        d->m_rowCache.clear();
+        d->m_rowCacheHeight = d->m_surface->fullSize().height();
         updateScrollBars();
         if (!setSelection(std::nullopt))
             updateViewport();
@@ -227,6 +281,18 @@ void TerminalView::setupSurface()
     updateScrollBars();
 }
 
+void TerminalView::setScrollbackMemoryLimit(qint64 bytes)
+{
+    d->m_scrollbackMemoryLimit = bytes;
+    if (d->m_surface)
+        d->m_surface->setScrollbackMemoryLimit(bytes);
+}
+
+qint64 TerminalView::scrollbackMemoryLimit() const
+{
+    return d->m_scrollbackMemoryLimit;
+}
+
 void TerminalView::setAllowBlinkingCursor(bool allow)
 {
     d->m_allowBlinkingCursor = allow;
@@ -266,6 +332,7 @@ void TerminalView::setColors(const std::array<QColor, 20> &newColors)
         return;
 
     d->m_currentColors = newColors;
+    d->m_rowCache.clear();
 
     updateViewport();
     update();
@@ -293,6 +360,7 @@ void TerminalView::setFont(const QFont &font)
                         << qfm.maxWidth() << viewport()->size();
 
     d->m_cellSize = {qfm.averageCharWidth(), (double) qCeil(qfm.height())};
+    d->m_rowCache.clear();
 
     QAbstractScrollArea::setFont(font);
 
@@ -410,29 +478,12 @@ QString TerminalView::textFromSelection() const
     if (d->m_selection->start == d->m_selection->end)
         return {};
 
-    CellIterator it = d->m_surface->iteratorAt(d->m_selection->start);
-    CellIterator end = d->m_surface->iteratorAt(d->m_selection->end);
-
-    if (it.position() > end.position()) {
+    if (d->m_selection->start > d->m_selection->end) {
         qCWarning(selectionLog) << "Invalid selection: start >= end";
         return {};
     }
 
-    std::u32string s;
-    bool previousWasZero = false;
-    for (; it != end; ++it) {
-        if (it.gridPos().x() == 0 && !s.empty() && previousWasZero)
-            s += U'\n';
-
-        if (*it != 0) {
-            previousWasZero = false;
-            s += *it;
-        } else {
-            previousWasZero = true;
-        }
-    }
-
-    return QString::fromUcs4(s.data(), static_cast<int>(s.size()));
+    return d->m_surface->textRange(d->m_selection->start, d->m_selection->end);
 }
 
 bool TerminalView::setSelection(const std::optional<Selection> &selection, bool scroll)
@@ -844,6 +895,87 @@ void TerminalView::paintPreedit(QPainter &p) const
     }
 }
 
+QList<int> TerminalView::rowOverlays(int row, QList<SearchHit>::const_iterator &searchIt) const
+{
+    // The selection, the link selection and all search hits that touch the row, as pairs
+    // of start and end column.
+    const int rowStart = row * d->m_surface->liveSize().width();
+    const int rowEnd = rowStart + d->m_surface->liveSize().width();
+    const auto addSpan = [rowStart, rowEnd](QList<int> &overlays, int start, int end) {
+        start = qBound(rowStart, start, rowEnd) - rowStart;
+        end = qBound(rowStart, end, rowEnd) - rowStart;
+        if (start >= end)
+            start = end = 0;
+        overlays << start << end;
+    };
+
+    QList<int> overlays;
+    if (d->m_selection)
+        addSpan(overlays, d->m_selection->start, d->m_selection->end);
+    else
+        overlays << 0 << 0;
+    if (d->m_linkSelection)
+        addSpan(overlays, d->m_linkSelection->start, d->m_linkSelection->end);
+    else
+        overlays << 0 << 0;
+
+    while (searchIt != searchHits().constEnd() && searchIt->end <= rowStart)
+        ++searchIt;
+    for (auto it = searchIt; it != searchHits().constEnd() && it->start < rowEnd; ++it)
+        addSpan(overlays, it->start, it->end);
+
+    return overlays;
+}
+
+QPixmap TerminalView::paintRow(int row,
+                               QFont &f,
+                               QList<SearchHit>::const_iterator searchIt,
+                               qreal devicePixelRatio) const
+{
+    const QSizeF size{d->m_cellSize.width() * d->m_surface->liveSize().width(),
+                      d->m_cellSize.height()};
+    QPixmap pixmap((size * devicePixelRatio).toSize());
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(d->m_currentColors[(size_t) WidgetColorIdx::Background]);
+
+    QPainter p(&pixmap);
+    p.translate(-gridToGlobal({0, row}));
+
+    if (!paintRowCells(p, row, f, searchIt))
+        return {};
+
+    return pixmap;
+}
+
+// Returns false if a glyph of the row is taller than the cell height.
+bool TerminalView::paintRowCells(QPainter &p,
+                                 int row,
+                                 QFont &f,
+                                 QList<SearchHit>::const_iterator searchIt) const
+{
+    bool fits = true;
+
+    for (int cellX = 0; cellX < d->m_surface->liveSize().width();) {
+        const auto cell = d->m_surface->fetchCell(cellX, row);
+
+        QRectF cellRect(gridToGlobal({cellX, row}),
+                        QSizeF{d->m_cellSize.width() * cell.width, d->m_cellSize.height()});
+
+        int numCells = paintCell(p, cellRect, {cellX, row}, cell, f, searchIt);
+
+        // paintCell() has set up the font of the cell, so this hits the glyph cache.
+        if (fits && !cell.text.isEmpty()) {
+            const auto r = GlyphCache::instance().get(f, cell.text);
+            if (r && r->boundingRect().height() > cellRect.height())
+                fits = false;
+        }
+
+        cellX += numCells;
+    }
+
+    return fits;
+}
+
 void TerminalView::paintCells(QPainter &p, QPaintEvent *event) const
 {
     QFont f = font();
@@ -865,18 +997,60 @@ void TerminalView::paintCells(QPainter &p, QPaintEvent *event) const
                                return d->m_surface->posToGrid(hit.start).y() < value;
                            });
 
-    for (int cellY = startRow; cellY < endRow; ++cellY) {
-        for (int cellX = 0; cellX < d->m_surface->liveSize().width();) {
-            const auto cell = d->m_surface->fetchCell(cellX, cellY);
-
-            QRectF cellRect(gridToGlobal({cellX, cellY}),
-                            QSizeF{d->m_cellSize.width() * cell.width, d->m_cellSize.height()});
+    // Keep a few screens worth of rows, so scrolling back and forth only paints new rows.
+    d->m_rowCache.setMaxCost(qMax(1, 3 * d->m_surface->liveSize().height()));
+
+    const qreal dpr = p.device()->devicePixelRatioF();
+    const QSize pixelSize = (QSizeF{d->m_cellSize.width() * d->m_surface->liveSize().width(),
+                                    d->m_cellSize.height()}
+                             * dpr)
+                                .toSize();
+
+    // Rows with tall glyphs are painted after all other rows, so their glyphs can overlap
+    // the neighbouring rows like they did before the row cache. This includes the rows
+    // just outside of the update area, whose glyphs may reach into it.
+    QList<QPair<int, QList<SearchHit>::const_iterator>> directRows;
+
+    const auto paintDirectLater = [&](int row) {
+        if (row < 0 || row >= maxRow)
+            return;
+        const TerminalViewPrivate::RowImage *image = d->m_rowCache.object(row);
+        if (image && image->pixmap.isNull()) {
+            directRows.append({row,
+                               std::lower_bound(searchHits().constBegin(),
+                                                searchHits().constEnd(),
+                                                row,
+                                                [this](const SearchHit &hit, int value) {
+                                                    return d->m_surface->posToGrid(hit.start).y()
+                                                           < value;
+                                                })});
+        }
+    };
 
-            int numCells = paintCell(p, cellRect, {cellX, cellY}, cell, f, searchIt);
+    paintDirectLater(startRow - 1);
 
-            cellX += numCells;
+    for (int cellY = startRow; cellY < endRow; ++cellY) {
+        const QList<SearchHit>::const_iterator rowSearchIt = searchIt;
+        QList<int> overlays = rowOverlays(cellY, searchIt);
+
+        TerminalViewPrivate::RowImage *image = d->m_rowCache.object(cellY);
+        if (!image || image->pixelSize != pixelSize || image->overlays != overlays) {
+            image = new TerminalViewPrivate::RowImage{paintRow(cellY, f, rowSearchIt, dpr),
+                                                      pixelSize,
+                                                      std::move(overlays)};
+            d->m_rowCache.insert(cellY, image);
         }
+
+        if (image->pixmap.isNull())
+            directRows.append({cellY, rowSearchIt});
+        else
+            p.drawPixmap(gridToGlobal({0, cellY}), image->pixmap);
     }
+
+    paintDirectLater(endRow);
+
+    for (const auto &[row, rowSearchIt] : std::as_const(directRows))
+        paintRowCells(p, row, f, rowSearchIt);
 }
 
 void TerminalView::paintDebugSelection(QPainter &p, const Selection &selection) const
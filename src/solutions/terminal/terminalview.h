@@ -4,6 +4,7 @@
 #pragma once
 
 #include "terminal_global.h"
+#include "terminalsearch.h"
 #include "terminalsurface.h"
 
 #include <QAbstractScrollArea>
@@ -20,18 +21,6 @@ namespace TerminalSolution {
 class SurfaceIntegration;
 class TerminalViewPrivate;
 
-struct SearchHit
-{
-    int start{-1};
-    int end{-1};
-
-    bool operator!=(const SearchHit &other) const
-    {
-        return start != other.start || end != other.end;
-    }
-    bool operator==(const SearchHit &other) const { return !operator!=(other); }
-};
-
 QString TERMINAL_EXPORT defaultFontFamily();
 int TERMINAL_EXPORT defaultFontSize();
 
@@ -92,6 +81,11 @@ public:
 
     void setPasswordMode(bool passwordMode);
 
+    // Scrollback beyond this many bytes is kept compressed in a temporary file.
+    // 0 keeps the whole scrollback in memory.
+    void setScrollbackMemoryLimit(qint64 bytes);
+    qint64 scrollbackMemoryLimit() const;
+
     struct Link
     {
         QString text;
@@ -119,11 +113,8 @@ public:
 
     void restart();
 
-    virtual const QList<SearchHit> &searchHits() const
-    {
-        static QList<SearchHit> noHits;
-        return noHits;
-    }
+    // The hits of search() unless overridden.
+    virtual const QList<SearchHit> &searchHits() const;
 
     virtual bool resizePty(QSize newSize)
     {
@@ -150,6 +141,7 @@ public:
     virtual void surfaceChanged(){};
 
     TerminalSurface *surface() const;
+    TerminalSearch *search() const;
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -178,6 +170,15 @@ protected:
                   QFont &f,
                   QList<SearchHit>::const_iterator &searchIt) const;
     void paintCells(QPainter &painter, QPaintEvent *event) const;
+    QPixmap paintRow(int row,
+                     QFont &f,
+                     QList<SearchHit>::const_iterator searchIt,
+                     qreal devicePixelRatio) const;
+    bool paintRowCells(QPainter &p,
+                       int row,
+                       QFont &f,
+                       QList<SearchHit>::const_iterator searchIt) const;
+    QList<int> rowOverlays(int row, QList<SearchHit>::const_iterator &searchIt) const;
     void paintCursor(QPainter &painter) const;
     void paintPreedit(QPainter &painter) const;
     bool paintFindMatches(QPainter &painter,
@@ -5,13 +5,190 @@
 #include "environment.h"
 
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QLoggingCategory>
+#include <QMap>
+#include <QMutex>
 #include <QTimer>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
 static Q_LOGGING_CATEGORY(benchmarksLog, "qtc.benchmark", QtWarningMsg);
 
 namespace Utils {
 
+namespace {
+
+class ResultSink
+{
+public:
+    static ResultSink &instance()
+    {
+        static ResultSink sink;
+        return sink;
+    }
+
+    void write(const QString &testsuite,
+               const QString &testcase,
+               const QString &tags,
+               const QList<qint64> &samplesNs)
+    {
+        if (m_filePath.isEmpty() || m_failed || samplesNs.isEmpty())
+            return;
+
+        QList<qint64> sorted = samplesNs;
+        std::sort(sorted.begin(), sorted.end());
+        QJsonArray samples;
+        double sum = 0;
+        for (qint64 sample : samplesNs) {
+            samples.append(sample);
+            sum += sample;
+        }
+
+        QJsonObject object;
+        object["suite"] = testsuite;
+        object["case"] = testcase;
+        object["tags"] = tags;
+        object["unit"] = "ns";
+        object["repeat"] = int(samplesNs.size());
+        object["samples"] = samples;
+        object["min"] = sorted.first();
+        object["median"] = sorted.at(sorted.size() / 2);
+        object["mean"] = sum / samplesNs.size();
+        object["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+        object["pid"] = QCoreApplication::applicationPid();
+        const QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+
+        QMutexLocker locker(&m_mutex);
+        if (m_failed)
+            return;
+        if (!m_file.isOpen() && !m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(benchmarksLog) << "Cannot open benchmark output" << m_filePath
+                                     << m_file.errorString();
+            m_failed = true;
+            return;
+        }
+        m_file.write(line);
+        m_file.flush();
+    }
+
+    QString filePath() const { return m_failed ? QString() : m_filePath; }
+
+private:
+    ResultSink()
+        : m_filePath(qtcEnvironmentVariable("QTC_BENCHMARK_OUTPUT"))
+        , m_file(m_filePath)
+    {}
+
+    const QString m_filePath;
+    std::atomic_bool m_failed = false; // Set once opening m_filePath failed.
+    QMutex m_mutex;
+    QFile m_file;
+};
+
+struct SampleSet
+{
+    QString testsuite;
+    QString testcase;
+    QString tags;
+    QList<double> samples;
+};
+
+using SampleSets = QMap<QString, SampleSet>;
+
+bool readResultFile(const QString &filePath, SampleSets *sets, QString *errorString)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorString)
+            *errorString = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty())
+            continue;
+        QJsonParseError error;
+        const QJsonObject object = QJsonDocument::fromJson(line, &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            if (errorString) {
+                *errorString = QString("%1:%2: %3")
+                                   .arg(filePath)
+                                   .arg(lineNumber)
+                                   .arg(error.errorString());
+            }
+            return false;
+        }
+
+        const QString suite = object["suite"].toString();
+        const QString testcase = object["case"].toString();
+        const QString tags = object["tags"].toString();
+        SampleSet &set = (*sets)[suite + "::" + testcase + '{' + tags + '}'];
+        set.testsuite = suite;
+        set.testcase = testcase;
+        set.tags = tags;
+        const QJsonArray samples = object["samples"].toArray();
+        for (const QJsonValue &sample : samples)
+            set.samples.append(sample.toDouble());
+    }
+    return true;
+}
+
+double mean(const QList<double> &values)
+{
+    double sum = 0;
+    for (double value : values)
+        sum += value;
+    return values.isEmpty() ? 0 : sum / values.size();
+}
+
+double variance(const QList<double> &values, double mean)
+{
+    if (values.size() < 2)
+        return 0;
+    double sum = 0;
+    for (double value : values)
+        sum += (value - mean) * (value - mean);
+    return sum / (values.size() - 1);
+}
+
+double median(QList<double> values)
+{
+    if (values.isEmpty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    const qsizetype mid = values.size() / 2;
+    return values.size() % 2 ? values.at(mid) : (values.at(mid - 1) + values.at(mid)) / 2;
+}
+
+// Two-sided critical values of Student's t for alpha = 0.05.
+double criticalT(double degreesOfFreedom)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    const int df = std::max(1, int(std::floor(degreesOfFreedom)));
+    if (df <= 30)
+        return table[df - 1];
+    if (df <= 60)
+        return 2.000;
+    if (df <= 120)
+        return 1.980;
+    return 1.960;
+}
+
+} // namespace
+
 Benchmarker::Benchmarker(const QString &testsuite, const QString &testcase,
                          const QString &tagData) :
     Benchmarker(benchmarksLog(), testsuite, testcase, tagData)
@@ -31,7 +208,7 @@ Benchmarker::Benchmarker(const QLoggingCategory &cat,
 Benchmarker::~Benchmarker()
 {
     if (m_timer.isValid())
-        report(m_timer.elapsed());
+        reportNs(m_timer.nsecsElapsed());
 }
 
 void Benchmarker::report(qint64 ms)
@@ -40,6 +217,12 @@ void Benchmarker::report(qint64 ms)
     report(m_category, m_testsuite, m_testcase, ms, m_tagData);
 }
 
+void Benchmarker::reportNs(qint64 ns)
+{
+    m_timer.invalidate();
+    reportNs(m_category, m_testsuite, m_testcase, {ns}, m_tagData);
+}
+
 void Benchmarker::report(const QString &testsuite,
                          const QString &testcase, qint64 ms, const QString &tags)
 {
@@ -48,18 +231,101 @@ void Benchmarker::report(const QString &testsuite,
 
 void Benchmarker::report(const QLoggingCategory &cat, const QString &testsuite, const QString &testcase,
                          qint64 ms, const QString &tags)
+{
+    reportNs(cat, testsuite, testcase, {ms * 1000 * 1000}, tags);
+}
+
+void Benchmarker::reportNs(const QString &testsuite, const QString &testcase,
+                           const QList<qint64> &samplesNs, const QString &tags)
+{
+    reportNs(benchmarksLog(), testsuite, testcase, samplesNs, tags);
+}
+
+void Benchmarker::reportNs(const QLoggingCategory &cat, const QString &testsuite,
+                           const QString &testcase, const QList<qint64> &samplesNs,
+                           const QString &tags)
 {
     static const QByteArray quitAfter = qtcEnvironmentVariable("QTC_QUIT_AFTER_BENCHMARK").toLatin1();
+    if (samplesNs.isEmpty())
+        return;
+
     QString t = "unit=ms";
+    if (samplesNs.size() > 1)
+        t += ",repeat=" + QString::number(samplesNs.size());
     if (!tags.isEmpty())
         t += "," + tags;
 
+    QList<qint64> sorted = samplesNs;
+    std::sort(sorted.begin(), sorted.end());
+    const qint64 ms = sorted.at(sorted.size() / 2) / (1000 * 1000);
+
     const QByteArray testSuite = testsuite.toUtf8();
     const QByteArray testCase = testcase.toUtf8();
     qCDebug(cat, "%s::%s: %lld { %s }", testSuite.data(), testCase.data(), ms, t.toUtf8().data());
+    ResultSink::instance().write(testsuite, testcase, tags, samplesNs);
     if (!quitAfter.isEmpty() && quitAfter == testSuite + "::" + testCase)
         QTimer::singleShot(1000, qApp, &QCoreApplication::quit);
 }
 
+QString Benchmarker::outputFilePath()
+{
+    return ResultSink::instance().filePath();
+}
+
+bool Benchmarker::compareResultFiles(const QString &baselineFile,
+                                     const QString &currentFile,
+                                     QList<Comparison> *comparisons,
+                                     double threshold,
+                                     QString *errorString)
+{
+    SampleSets baseline;
+    SampleSets current;
+    if (!readResultFile(baselineFile, &baseline, errorString)
+        || !readResultFile(currentFile, &current, errorString)) {
+        return false;
+    }
+
+    comparisons->clear();
+    for (auto it = current.cbegin(); it != current.cend(); ++it) {
+        const auto base = baseline.constFind(it.key());
+        if (base == baseline.cend())
+            continue;
+        const QList<double> &a = base->samples;
+        const QList<double> &b = it->samples;
+        if (a.isEmpty() || b.isEmpty())
+            continue;
+
+        Comparison comparison;
+        comparison.testsuite = it->testsuite;
+        comparison.testcase = it->testcase;
+        comparison.tags = it->tags;
+        comparison.baselineCount = a.size();
+        comparison.currentCount = b.size();
+        comparison.baselineMedianNs = median(a);
+        comparison.currentMedianNs = median(b);
+
+        const double meanA = mean(a);
+        const double meanB = mean(b);
+        if (meanA > 0)
+            comparison.change = (meanB - meanA) / meanA;
+
+        if (a.size() >= 2 && b.size() >= 2) {
+            const double va = variance(a, meanA) / a.size();
+            const double vb = variance(b, meanB) / b.size();
+            if (va + vb > 0) {
+                comparison.tValue = (meanB - meanA) / std::sqrt(va + vb);
+                const double df = (va + vb) * (va + vb)
+                                  / (va * va / (a.size() - 1) + vb * vb / (b.size() - 1));
+                comparison.significant = std::abs(comparison.tValue) > criticalT(df);
+            } else {
+                // Identical constant samples on both sides: any difference is exact.
+                comparison.significant = meanA != meanB;
+            }
+        }
+        comparison.regression = comparison.significant && comparison.change > threshold;
+        comparisons->append(comparison);
+    }
+    return true;
+}
 
 } // namespace Utils
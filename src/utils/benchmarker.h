@@ -6,6 +6,7 @@
 #include "utils_global.h"
 
 #include <QElapsedTimer>
+#include <QList>
 #include <QString>
 
 QT_BEGIN_NAMESPACE
@@ -27,6 +28,7 @@ public:
     ~Benchmarker();
 
     void report(qint64 ms);
+    void reportNs(qint64 ns);
     static void report(const QString &testsuite,
                        const QString &testcase,
                        qint64 ms,
@@ -36,6 +38,41 @@ public:
                        const QString &testcase,
                        qint64 ms,
                        const QString &tags = QString());
+    // One entry per repetition, in nanoseconds.
+    static void reportNs(const QString &testsuite,
+                         const QString &testcase,
+                         const QList<qint64> &samplesNs,
+                         const QString &tags = QString());
+    static void reportNs(const QLoggingCategory &cat,
+                         const QString &testsuite,
+                         const QString &testcase,
+                         const QList<qint64> &samplesNs,
+                         const QString &tags = QString());
+
+    // Results are appended as JSON lines to the file named by QTC_BENCHMARK_OUTPUT.
+    static QString outputFilePath();
+
+    struct Comparison
+    {
+        QString testsuite;
+        QString testcase;
+        QString tags;
+        int baselineCount = 0;
+        int currentCount = 0;
+        double baselineMedianNs = 0;
+        double currentMedianNs = 0;
+        double change = 0;      // (current - baseline) / baseline of the means
+        double tValue = 0;      // Welch's t, 0 if either side has fewer than two samples
+        bool significant = false; // two-sided, alpha = 0.05
+        bool regression = false;  // significant and slower by more than the threshold
+    };
+
+    // Samples of all lines with the same suite, case and tags are pooled per file.
+    static bool compareResultFiles(const QString &baselineFile,
+                                   const QString &currentFile,
+                                   QList<Comparison> *comparisons,
+                                   double threshold = 0.05,
+                                   QString *errorString = nullptr);
 
 private:
     const QLoggingCategory &m_category;
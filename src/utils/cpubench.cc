@@ -0,0 +1,239 @@
+#include "cpubench.hpp"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QMetaEnum>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+#include <latch>
+#include <thread>
+#include <vector>
+
+namespace Utils {
+
+auto CpuBenchOptions::defaultThreadCounts() -> QList<int>
+{
+    const int ideal = qMax(1, QThread::idealThreadCount());
+    QList<int> counts;
+    for (int count = 1; count < ideal; count *= 2) {
+        counts.append(count);
+    }
+    counts.append(ideal);
+    return counts;
+}
+
+auto CpuBenchOptions::defaultBufferSizes() -> QList<qint64>
+{
+    QList<qint64> sizes;
+    for (qint64 size = 4 * 1024; size <= 64 * 1024 * 1024; size *= 4) {
+        sizes.append(size);
+    }
+    return sizes;
+}
+
+auto CpuBenchResult::algorithmName() const -> QString
+{
+    return QString::fromLatin1(
+        QMetaEnum::fromType<QCryptographicHash::Algorithm>().valueToKey(algorithm));
+}
+
+static auto allAlgorithms() -> QList<QCryptographicHash::Algorithm>
+{
+    QList<QCryptographicHash::Algorithm> algorithms;
+    const auto metaEnum = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (int i = 0; i < metaEnum.keyCount(); ++i) {
+        const auto value = static_cast<QCryptographicHash::Algorithm>(metaEnum.value(i));
+        if (value == QCryptographicHash::NumAlgorithms
+            || !QCryptographicHash::supportsAlgorithm(value) || algorithms.contains(value)) {
+            continue;
+        }
+        algorithms.append(value);
+    }
+    return algorithms;
+}
+
+static auto randomData(qint64 size) -> QByteArray
+{
+    QByteArray data(size, '\0');
+    const auto words = size / qint64(sizeof(quint32));
+    QRandomGenerator::global()->fillRange(reinterpret_cast<quint32 *>(data.data()), words);
+    return data;
+}
+
+// 分位数（最近秩法），values 需已升序排列
+static auto percentile(const QList<double> &values, double p) -> double
+{
+    if (values.isEmpty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<qsizetype>(std::ceil(p * values.size()));
+    return values.at(std::clamp<qsizetype>(rank - 1, 0, values.size() - 1));
+}
+
+// 一次采样：threads 个线程同时对同一份只读数据反复计算哈希，返回合计 MB/s
+static auto sampleOnce(QCryptographicHash::Algorithm algorithm,
+                       int threads,
+                       const QByteArray &data,
+                       int durationMs,
+                       const std::atomic_bool &canceled) -> double
+{
+    const qint64 durationNs = qint64(durationMs) * 1000 * 1000;
+    std::vector<double> throughputs(threads, 0.0);
+    std::latch ready(threads);
+
+    auto worker = [&](int index) {
+        QCryptographicHash hash(algorithm);
+        volatile char dummy = 0; // 防止编译器优化
+        ready.arrive_and_wait(); // 所有线程同时开始
+
+        QElapsedTimer timer;
+        timer.start();
+        qint64 totalBytes = 0;
+        qint64 elapsedNs = 0;
+        do {
+            hash.reset();
+            hash.addData(data);
+            dummy = hash.resultView().at(0);
+            totalBytes += data.size();
+            elapsedNs = timer.nsecsElapsed();
+        } while (elapsedNs < durationNs && !canceled.load(std::memory_order_relaxed));
+        Q_UNUSED(dummy)
+
+        throughputs[index] = (totalBytes / (qMax<qint64>(elapsedNs, 1) / 1e9)) / (1024 * 1024);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto &thread : workers) {
+        thread.join();
+    }
+
+    double total = 0.0;
+    for (const auto value : throughputs) {
+        total += value;
+    }
+    return total;
+}
+
+auto runCpuBenchSuite(const CpuBenchOptions &options,
+                      const std::atomic_bool &canceled,
+                      const std::function<void(const CpuBenchResult &)> &onResult)
+    -> QList<CpuBenchResult>
+{
+    const auto algorithms = options.algorithms.isEmpty() ? allAlgorithms() : options.algorithms;
+    const auto threadCounts = options.threadCounts.isEmpty()
+                                  ? CpuBenchOptions::defaultThreadCounts()
+                                  : options.threadCounts;
+    const auto bufferSizes = options.bufferSizes.isEmpty() ? CpuBenchOptions::defaultBufferSizes()
+                                                           : options.bufferSizes;
+    const int iterations = qMax(1, options.iterations);
+
+    QList<CpuBenchResult> results;
+    for (const auto bufferSize : bufferSizes) {
+        const auto data = randomData(bufferSize);
+        for (const auto algorithm : algorithms) {
+            double singleThreadMedian = 0.0;
+            for (const auto threads : threadCounts) {
+                CpuBenchResult result;
+                result.algorithm = algorithm;
+                result.threads = qMax(1, threads);
+                result.bufferSize = bufferSize;
+                for (int i = 0; i < iterations && !canceled.load(); ++i) {
+                    result.samples.append(
+                        sampleOnce(algorithm, result.threads, data, options.durationMs, canceled));
+                }
+                if (canceled.load()) {
+                    return results; // 被中断的组合样本不完整，丢弃
+                }
+
+                auto sorted = result.samples;
+                std::sort(sorted.begin(), sorted.end());
+                result.min = sorted.first();
+                result.max = sorted.last();
+                result.median = percentile(sorted, 0.5);
+                result.p95 = percentile(sorted, 0.95);
+                if (result.threads == 1) {
+                    singleThreadMedian = result.median;
+                }
+                if (singleThreadMedian > 0.0) {
+                    result.scalingEfficiency = result.median
+                                               / (result.threads * singleThreadMedian);
+                }
+
+                results.append(result);
+                if (onResult) {
+                    onResult(result);
+                }
+            }
+        }
+    }
+    return results;
+}
+
+auto cpuBenchResultsToJson(const CpuBenchOptions &options, const QList<CpuBenchResult> &results)
+    -> QJsonObject
+{
+    QJsonObject system;
+    system["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    system["kernel"] = QSysInfo::kernelType() + ' ' + QSysInfo::kernelVersion();
+    system["os"] = QSysInfo::prettyProductName();
+    system["hostName"] = QSysInfo::machineHostName();
+    system["idealThreadCount"] = QThread::idealThreadCount();
+
+    QJsonObject settings;
+    settings["iterations"] = options.iterations;
+    settings["durationMs"] = options.durationMs;
+
+    QJsonArray array;
+    for (const auto &result : std::as_const(results)) {
+        QJsonArray samples;
+        for (const auto sample : result.samples) {
+            samples.append(sample);
+        }
+        QJsonObject object;
+        object["algorithm"] = result.algorithmName();
+        object["threads"] = result.threads;
+        object["bufferSize"] = result.bufferSize;
+        object["medianMBps"] = result.median;
+        object["p95MBps"] = result.p95;
+        object["minMBps"] = result.min;
+        object["maxMBps"] = result.max;
+        object["scalingEfficiency"] = result.scalingEfficiency;
+        object["samplesMBps"] = samples;
+        array.append(object);
+    }
+
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["system"] = system;
+    root["settings"] = settings;
+    root["results"] = array;
+    return root;
+}
+
+auto cpuBenchResultsToCsv(const QList<CpuBenchResult> &results) -> QByteArray
+{
+    QByteArray csv(
+        "algorithm,threads,buffer_size,median_mbps,p95_mbps,min_mbps,max_mbps,scaling_efficiency\n");
+    for (const auto &result : std::as_const(results)) {
+        csv += result.algorithmName().toLatin1() + ',' + QByteArray::number(result.threads) + ','
+               + QByteArray::number(result.bufferSize) + ','
+               + QByteArray::number(result.median, 'f', 2) + ','
+               + QByteArray::number(result.p95, 'f', 2) + ','
+               + QByteArray::number(result.min, 'f', 2) + ','
+               + QByteArray::number(result.max, 'f', 2) + ','
+               + QByteArray::number(result.scalingEfficiency, 'f', 3) + '\n';
+    }
+    return csv;
+}
+
+} // namespace Utils
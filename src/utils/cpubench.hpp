@@ -0,0 +1,52 @@
+#pragma once
+
+#include "utils_global.h"
+
+#include <QCryptographicHash>
+#include <QJsonObject>
+
+#include <atomic>
+#include <functional>
+
+namespace Utils {
+
+// 哈希吞吐量基准套件：算法 × 线程数 × 缓冲区大小 的全组合矩阵
+struct UTILS_EXPORT CpuBenchOptions
+{
+    QList<QCryptographicHash::Algorithm> algorithms; // 为空时测试全部算法
+    QList<int> threadCounts;                          // 为空时为 1, 2, 4, ... idealThreadCount()
+    QList<qint64> bufferSizes;                        // 为空时为 4KB, 16KB, ... 64MB
+    int iterations = 5;                               // 每个组合的采样次数
+    int durationMs = 200;                             // 每次采样的时长
+
+    static auto defaultThreadCounts() -> QList<int>;
+    static auto defaultBufferSizes() -> QList<qint64>;
+};
+
+struct UTILS_EXPORT CpuBenchResult
+{
+    QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha256;
+    int threads = 1;
+    qint64 bufferSize = 0;
+    QList<double> samples; // MB/s，所有线程合计
+    double median = 0.0;
+    double p95 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    // 相对单线程中位数的扩展效率：median / (threads * median(1 线程))，没有单线程数据时为 0
+    double scalingEfficiency = 0.0;
+
+    [[nodiscard]] auto algorithmName() const -> QString;
+};
+
+// 依次运行所有组合，每完成一个组合回调一次 onResult；canceled 变为 true 时提前返回已完成的部分
+UTILS_EXPORT auto runCpuBenchSuite(const CpuBenchOptions &options,
+                                   const std::atomic_bool &canceled,
+                                   const std::function<void(const CpuBenchResult &)> &onResult = {})
+    -> QList<CpuBenchResult>;
+
+UTILS_EXPORT auto cpuBenchResultsToJson(const CpuBenchOptions &options,
+                                        const QList<CpuBenchResult> &results) -> QJsonObject;
+UTILS_EXPORT auto cpuBenchResultsToCsv(const QList<CpuBenchResult> &results) -> QByteArray;
+
+} // namespace Utils
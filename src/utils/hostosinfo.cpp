@@ -7,6 +7,7 @@
 #include "utilstr.h"
 
 #include <QDir>
+#include <QFile>
 
 #if !defined(QT_NO_OPENGL) && defined(QT_GUI_LIB)
 #include <QOpenGLContext>
@@ -21,6 +22,7 @@
 #endif
 
 #ifdef Q_OS_MACOS
+#include <mach/mach.h>
 #include <sys/sysctl.h>
 #endif
 
@@ -87,6 +89,46 @@ std::optional<quint64> HostOsInfo::totalMemoryInstalledInBytes()
     return {};
 }
 
+std::optional<quint64> HostOsInfo::availableMemoryInBytes()
+{
+#ifdef Q_OS_LINUX
+    // MemAvailable includes the page cache and other memory the kernel can reclaim.
+    QFile meminfo("/proc/meminfo");
+    if (meminfo.open(QIODevice::ReadOnly)) {
+        while (!meminfo.atEnd()) {
+            const QByteArray line = meminfo.readLine();
+            if (!line.startsWith("MemAvailable:"))
+                continue;
+            bool ok = false;
+            const quint64 kib = line.mid(13).trimmed().split(' ').first().toULongLong(&ok);
+            if (ok)
+                return kib * 1024;
+            break;
+        }
+    }
+    // Kernels before 3.14 have no MemAvailable.
+    struct sysinfo info;
+    if (sysinfo(&info) == -1)
+        return {};
+    return (quint64(info.freeram) + info.bufferram) * info.mem_unit;
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX statex;
+    statex.dwLength = sizeof statex;
+    if (!GlobalMemoryStatusEx(&statex))
+        return {};
+    return statex.ullAvailPhys;
+#elif defined(Q_OS_MACOS)
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if (host_statistics64(mach_host_self(), HOST_VM_INFO64, host_info64_t(&stats), &count)
+        != KERN_SUCCESS) {
+        return {};
+    }
+    return (quint64(stats.free_count) + stats.inactive_count) * vm_page_size;
+#endif
+    return {};
+}
+
 const FilePath &HostOsInfo::root()
 {
     static const FilePath rootDir = FilePath::fromUserInput(QDir::rootPath());
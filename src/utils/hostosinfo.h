@@ -117,6 +117,7 @@ public:
     }
 
     static std::optional<quint64> totalMemoryInstalledInBytes();
+    static std::optional<quint64> availableMemoryInBytes();
 
     static const FilePath &root();
 
@@ -1,6 +1,8 @@
 #include "languagemanager.hpp"
 #include "utils.hpp"
 
+#include <QMutex>
+
 namespace Utils {
 
 class LanguageManager::LanguageManagerPrivate
@@ -11,11 +13,35 @@ public:
     {}
     ~LanguageManagerPrivate() {}
 
+    void loadTranslators(QTranslator *translator, QTranslator *qtTranslator) const
+    {
+#ifdef Q_OS_MACOS
+        auto translationsPath = qApp->applicationDirPath() + "/../Resources/translations/";
+#else
+        auto translationsPath = qApp->applicationDirPath() + "/translations/";
+#endif
+        switch (currentLanguage) {
+        case Chinese:
+            qInfo() << translator->load(translationsPath + "qt-app_zh_CN.qm")
+                    << qtTranslator->load(translationsPath + "qt_zh_CN.qm");
+            break;
+        default:
+            qInfo() << translator->load(translationsPath + "qt-app_en.qm")
+                    << qtTranslator->load(translationsPath + "qt_en.qm");
+            break;
+        }
+    }
+
     LanguageManager *q_ptr;
 
     Language currentLanguage = Chinese;
     QScopedPointer<QTranslator> translatorPtr;
     QScopedPointer<QTranslator> qtTranslatorPtr;
+
+    // prepareLanguage() 在工作线程中加载好的翻译，等待 loadLanguage() 安装
+    QMutex preparedMutex;
+    QScopedPointer<QTranslator> preparedTranslatorPtr;
+    QScopedPointer<QTranslator> preparedQtTranslatorPtr;
 };
 
 LanguageManager::LanguageManager(QObject *parent)
@@ -33,9 +59,28 @@ LanguageManager::Language LanguageManager::currentLanguage()
 void LanguageManager::loadLanguage(Language language)
 {
     d_ptr->currentLanguage = language;
+    {
+        QMutexLocker locker(&d_ptr->preparedMutex);
+        d_ptr->preparedTranslatorPtr.reset();
+        d_ptr->preparedQtTranslatorPtr.reset();
+    }
     loadLanguage();
 }
 
+void LanguageManager::prepareLanguage()
+{
+    auto *translator = new QTranslator;
+    auto *qtTranslator = new QTranslator;
+    d_ptr->loadTranslators(translator, qtTranslator);
+    // 在工作线程中创建的对象要移回 LanguageManager 所在的线程
+    translator->moveToThread(thread());
+    qtTranslator->moveToThread(thread());
+
+    QMutexLocker locker(&d_ptr->preparedMutex);
+    d_ptr->preparedTranslatorPtr.reset(translator);
+    d_ptr->preparedQtTranslatorPtr.reset(qtTranslator);
+}
+
 void LanguageManager::loadLanguage()
 {
     if (!d_ptr->translatorPtr.isNull()) {
@@ -44,22 +89,15 @@ void LanguageManager::loadLanguage()
     if (!d_ptr->qtTranslatorPtr.isNull()) {
         qApp->removeTranslator(d_ptr->qtTranslatorPtr.data());
     }
-    d_ptr->translatorPtr.reset(new QTranslator);
-    d_ptr->qtTranslatorPtr.reset(new QTranslator);
-#ifdef Q_OS_MACOS
-    auto translationsPath = qApp->applicationDirPath() + "/../Resources/translations/";
-#else
-    auto translationsPath = qApp->applicationDirPath() + "/translations/";
-#endif
-    switch (d_ptr->currentLanguage) {
-    case Chinese:
-        qInfo() << d_ptr->translatorPtr->load(translationsPath + "qt-app_zh_CN.qm")
-                << d_ptr->qtTranslatorPtr->load(translationsPath + "qt_zh_CN.qm");
-        break;
-    default:
-        qInfo() << d_ptr->translatorPtr->load(translationsPath + "qt-app_en.qm")
-                << d_ptr->qtTranslatorPtr->load(translationsPath + "qt_en.qm");
-        break;
+    {
+        QMutexLocker locker(&d_ptr->preparedMutex);
+        d_ptr->translatorPtr.reset(d_ptr->preparedTranslatorPtr.take());
+        d_ptr->qtTranslatorPtr.reset(d_ptr->preparedQtTranslatorPtr.take());
+    }
+    if (d_ptr->translatorPtr.isNull() || d_ptr->qtTranslatorPtr.isNull()) {
+        d_ptr->translatorPtr.reset(new QTranslator);
+        d_ptr->qtTranslatorPtr.reset(new QTranslator);
+        d_ptr->loadTranslators(d_ptr->translatorPtr.data(), d_ptr->qtTranslatorPtr.data());
     }
     qApp->installTranslator(d_ptr->translatorPtr.data());
     qApp->installTranslator(d_ptr->qtTranslatorPtr.data());
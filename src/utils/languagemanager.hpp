@@ -20,6 +20,8 @@ public:
     Language currentLanguage();
 
     void loadLanguage(Language language);
+    // 在任意线程中提前加载翻译文件，下一次 loadLanguage() 只需安装
+    void prepareLanguage();
     void loadLanguage();
 
     void saveSettings(QSettings &settings);
@@ -1,83 +1,73 @@
 #include "logasync.h"
 #include "logfile.hpp"
+#include "logrecord.hpp"
+#include "logringbuffer.hpp"
 #include "utils.hpp"
 
-#include <semaphore>
 #include <QDateTime>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSemaphore>
+#include <QStringEncoder>
+
+#include <optional>
+#include <semaphore>
 
 namespace Utils {
 
-// 消息处理函数
+// QtMsgType 的枚举值并不按严重程度排列（QtInfoMsg 最大）
+static auto severity(QtMsgType type) -> int
+{
+    switch (type) {
+    case QtDebugMsg: return 0;
+    case QtInfoMsg: return 1;
+    case QtWarningMsg: return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg: return 4;
+    }
+    return 4;
+}
+
+// 消息处理函数，只记录原始字段，写入文件的文本由日志线程渲染。
+// 级别过滤由分类过滤器完成，能走到这里的消息都是已启用的。
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
     auto *instance = LogAsync::instance();
-    if (type < instance->logLevel()) {
+
+    LogRecord record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.threadId = reinterpret_cast<quint64>(QThread::currentThreadId());
+    record.type = type;
+    record.category = QByteArrayView(context.category);
+    // By default, this information is recorded only in debug builds.
+    // You can overwrite this explicitly by defining QT_MESSAGELOGCONTEXT or QT_NO_MESSAGELOGCONTEXT.
+#ifndef QT_NO_DEBUG
+    record.file = QByteArrayView(context.file);
+    record.line = context.line;
+#endif
+
+    const auto orientation = instance->orientation();
+    if (orientation != LogAsync::Orientation::Standard) {
+        instance->append(record, msg);
+    }
+    if (orientation == LogAsync::Orientation::File) {
         return;
     }
 
     FILE *stdPrint = stdout;
-    QString level;
     switch (type) {
-    case QtDebugMsg:
-        level = QString("%1").arg("Debug", -7);
-        stdPrint = stdout;
-        break;
     case QtWarningMsg:
-        level = QString("%1").arg("Warning", -7);
-        stdPrint = stderr;
-        break;
     case QtCriticalMsg:
-        level = QString("%1").arg("Critica", -7);
-        stdPrint = stderr;
-        break;
-    case QtFatalMsg:
-        level = QString("%1").arg("Fatal", -7);
-        stdPrint = stderr;
-        break;
-    case QtInfoMsg:
-        level = QString("%1").arg("Info", -7);
-        stdPrint = stdout;
-        break;
-    default: level = QString("%1").arg("Unknown", -7); break;
-    }
-
-    const auto dataTimeString(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"));
-    const auto threadId = QString("%1").arg(reinterpret_cast<quint64>(QThread::currentThreadId()),
-                                            5,
-                                            10,
-                                            QLatin1Char('0'));
-    // By default, this information is recorded only in debug builds.
-    // You can overwrite this explicitly by defining QT_MESSAGELOGCONTEXT or QT_NO_MESSAGELOGCONTEXT.
-    QString contexInfo;
-#ifndef QT_NO_DEBUG
-    contexInfo = QString("File:(%1) Line:(%2)").arg(context.file).arg(context.line);
-#endif
-    const auto printToFile = QString("%1 %2 [%3] %4 - %5\n")
-                                 .arg(dataTimeString, threadId, level, msg, contexInfo);
-    QString printToConsole;
-    if (msg.size() > instance->maxConsoleLineSize()) {
-        printToConsole = QString("%1 %2 [%3] %4 - %5\n")
-                             .arg(dataTimeString,
-                                  threadId,
-                                  level,
-                                  msg.left(instance->maxConsoleLineSize()),
-                                  contexInfo);
-    } else {
-        printToConsole = printToFile;
-    }
-
-    switch (instance->orientation()) {
-    case LogAsync::Orientation::File: emit instance->appendBuf(printToFile); break;
-    case LogAsync::Orientation::StandardAndFile:
-        emit instance->appendBuf(printToFile);
-        fprintf(stdPrint, "%s", printToConsole.toLocal8Bit().constData());
-        ::fflush(stdPrint);
-        break;
-    default:
-        fprintf(stdPrint, "%s", printToConsole.toLocal8Bit().constData());
-        ::fflush(stdPrint);
-        break;
+    case QtFatalMsg: stdPrint = stderr; break;
+    default: break;
     }
+    const auto printToConsole = formatLogRecord(record,
+                                                msg.size() > instance->maxConsoleLineSize()
+                                                    ? msg.left(instance->maxConsoleLineSize())
+                                                    : msg);
+    fprintf(stdPrint, "%s", printToConsole.toLocal8Bit().constData());
+    ::fflush(stdPrint);
 }
 
 class LogAsync::LogAsyncPrivate
@@ -90,12 +80,128 @@ public:
     LogAsync *q_ptr;
 
     QString logPath;
+    LogRotationPolicy rotationPolicy;
     bool autoDelFile = false;
     qint64 autoDelFileDays = 7;
     QtMsgType msgType = QtWarningMsg;
+    QHash<QString, QtMsgType> categoryLevels;
+    QReadWriteLock levelLock;
     LogAsync::Orientation orientation = LogAsync::Orientation::Standard;
+    LogAsync::FileFormat fileFormat = LogAsync::FileFormat::Text;
+    LogAsync::WriteMode writeMode = LogAsync::WriteMode::Buffered;
+    int syncInterval = 0;
     int maxConsoleLineSize = 1024 * 10;
     std::binary_semaphore semaphore{0};
+
+    LogAsync::OverflowPolicy overflowPolicy = LogAsync::OverflowPolicy::Block;
+    int bufferCapacity = 8192;
+    int bufferSlotSize = 512;
+    std::unique_ptr<LogRingBuffer> ringBuffer;
+    std::atomic_bool running{false};
+    std::atomic_bool drainPending{false};
+    quint64 reportedDropped = 0;
+
+    // 只在唤醒日志线程时加锁，每批消息至多一次
+    QMutex logFileMutex;
+    LogFile *logFile = nullptr;
+
+    void scheduleDrain()
+    {
+        if (drainPending.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        QMutexLocker locker(&logFileMutex);
+        if (logFile == nullptr) {
+            return; // 日志线程正在退出，剩余消息由 run() 收尾
+        }
+        QMetaObject::invokeMethod(
+            logFile, [this, file = logFile] { drain(file); }, Qt::QueuedConnection);
+    }
+
+    void drain(LogFile *file)
+    {
+        drainPending.exchange(false, std::memory_order_acq_rel);
+        ringBuffer->drain([this, file](QByteArrayView data) { writeRecord(file, data); });
+
+        const auto dropped = ringBuffer->droppedMessages();
+        if (dropped != reportedDropped) {
+            const auto message = QString("%1 log messages dropped")
+                                     .arg(dropped - reportedDropped)
+                                     .toUtf8();
+            LogRecord record;
+            record.timestamp = QDateTime::currentMSecsSinceEpoch();
+            record.threadId = reinterpret_cast<quint64>(QThread::currentThreadId());
+            record.type = QtWarningMsg;
+            record.message = message;
+            QByteArray data(logRecordOverhead(record) + message.size(), Qt::Uninitialized);
+            auto *end = encodeLogRecordPrefix(data.data(), record);
+            memcpy(end, message.constData(), message.size());
+            finishLogRecord(data.data(), end + message.size());
+            writeRecord(file, data);
+            reportedDropped = dropped;
+        }
+    }
+
+    // 精确名称优先，其次是最长的 "prefix.*" 通配规则
+    auto categoryLevel(const QString &name) const -> std::optional<QtMsgType>
+    {
+        if (auto it = categoryLevels.constFind(name); it != categoryLevels.cend()) {
+            return it.value();
+        }
+        std::optional<QtMsgType> level;
+        qsizetype matched = -1;
+        for (auto it = categoryLevels.cbegin(); it != categoryLevels.cend(); ++it) {
+            const auto &pattern = it.key();
+            if (!pattern.endsWith('*')) {
+                continue;
+            }
+            const auto prefix = QStringView(pattern).chopped(1);
+            if (prefix.size() > matched && name.startsWith(prefix)) {
+                matched = prefix.size();
+                level = it.value();
+            }
+        }
+        return level;
+    }
+
+    static void categoryFilter(QLoggingCategory *category)
+    {
+        if (previousCategoryFilter) {
+            previousCategoryFilter(category); // 先应用 QT_LOGGING_RULES 等规则
+        }
+        auto *d = filterInstance;
+        if (d == nullptr) {
+            return;
+        }
+
+        QReadLocker locker(&d->levelLock);
+        const auto level = d->categoryLevel(QString::fromLatin1(category->categoryName()));
+        for (const auto type : {QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg}) {
+            // 单独设置过级别的分类完全由该级别决定，其余分类只会被全局级别进一步收紧
+            const auto enabled = level ? severity(type) >= severity(*level)
+                                       : category->isEnabled(type)
+                                             && severity(type) >= severity(d->msgType);
+            category->setEnabled(type, enabled);
+        }
+    }
+
+    // 重新安装过滤器会对所有已注册的分类重新求值，调用时不能持有 levelLock
+    static void reapplyCategoryFilter() { QLoggingCategory::installFilter(categoryFilter); }
+
+    static inline QLoggingCategory::CategoryFilter previousCategoryFilter = nullptr;
+    static inline LogAsyncPrivate *filterInstance = nullptr;
+
+    void writeRecord(LogFile *file, QByteArrayView data)
+    {
+        if (file->format() == LogAsync::FileFormat::Binary) {
+            file->write(data);
+            return;
+        }
+        LogRecord record;
+        if (decodeLogRecord(data, &record) > 0) {
+            file->write(formatLogRecord(record).toUtf8());
+        }
+    }
 };
 
 void LogAsync::setLogPath(const QString &path)
@@ -108,6 +214,16 @@ auto LogAsync::logPath() -> QString
     return d_ptr->logPath;
 }
 
+void LogAsync::setRotationPolicy(const LogRotationPolicy &policy)
+{
+    d_ptr->rotationPolicy = policy;
+}
+
+auto LogAsync::rotationPolicy() -> LogRotationPolicy
+{
+    return d_ptr->rotationPolicy;
+}
+
 void LogAsync::setAutoDelFile(bool on)
 {
     d_ptr->autoDelFile = on;
@@ -138,16 +254,77 @@ auto LogAsync::orientation() -> LogAsync::Orientation
     return d_ptr->orientation;
 }
 
+void LogAsync::setFileFormat(FileFormat format)
+{
+    d_ptr->fileFormat = format;
+}
+
+auto LogAsync::fileFormat() -> FileFormat
+{
+    return d_ptr->fileFormat;
+}
+
+void LogAsync::setWriteMode(WriteMode mode)
+{
+    d_ptr->writeMode = mode;
+}
+
+auto LogAsync::writeMode() -> WriteMode
+{
+    return d_ptr->writeMode;
+}
+
+void LogAsync::setSyncInterval(int ms)
+{
+    d_ptr->syncInterval = qMax(0, ms);
+}
+
+auto LogAsync::syncInterval() -> int
+{
+    return d_ptr->syncInterval;
+}
+
 void LogAsync::setLogLevel(QtMsgType type)
 {
-    d_ptr->msgType = type;
+    {
+        QWriteLocker locker(&d_ptr->levelLock);
+        d_ptr->msgType = type;
+    }
+    LogAsyncPrivate::reapplyCategoryFilter();
 }
 
 auto LogAsync::logLevel() -> QtMsgType
 {
+    QReadLocker locker(&d_ptr->levelLock);
     return d_ptr->msgType;
 }
 
+void LogAsync::setCategoryLogLevel(const QString &category, QtMsgType type)
+{
+    {
+        QWriteLocker locker(&d_ptr->levelLock);
+        d_ptr->categoryLevels.insert(category, type);
+    }
+    LogAsyncPrivate::reapplyCategoryFilter();
+}
+
+void LogAsync::resetCategoryLogLevel(const QString &category)
+{
+    {
+        QWriteLocker locker(&d_ptr->levelLock);
+        if (d_ptr->categoryLevels.remove(category) == 0) {
+            return;
+        }
+    }
+    LogAsyncPrivate::reapplyCategoryFilter();
+}
+
+auto LogAsync::categoryLogLevels() -> QHash<QString, QtMsgType>
+{
+    QReadLocker locker(&d_ptr->levelLock);
+    return d_ptr->categoryLevels;
+}
+
 void LogAsync::setMaxConsoleLineSize(int size)
 {
     if (size < 1) {
@@ -161,15 +338,120 @@ auto LogAsync::maxConsoleLineSize() -> int
     return d_ptr->maxConsoleLineSize;
 }
 
+void LogAsync::setOverflowPolicy(OverflowPolicy policy)
+{
+    d_ptr->overflowPolicy = policy;
+}
+
+auto LogAsync::overflowPolicy() -> OverflowPolicy
+{
+    return d_ptr->overflowPolicy;
+}
+
+void LogAsync::setBufferCapacity(int slots)
+{
+    if (slots < 2) {
+        return;
+    }
+    d_ptr->bufferCapacity = slots;
+}
+
+auto LogAsync::bufferCapacity() -> int
+{
+    return d_ptr->bufferCapacity;
+}
+
+void LogAsync::setBufferSlotSize(int bytes)
+{
+    if (bytes < 1) {
+        return;
+    }
+    d_ptr->bufferSlotSize = bytes;
+}
+
+auto LogAsync::bufferSlotSize() -> int
+{
+    return d_ptr->bufferSlotSize;
+}
+
+auto LogAsync::droppedMessages() -> quint64
+{
+    return d_ptr->ringBuffer ? d_ptr->ringBuffer->droppedMessages() : 0;
+}
+
+void LogAsync::append(const LogRecord &record, QStringView msg)
+{
+    if (!d_ptr->running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // 与 LogRingBuffer::OverflowPolicy 的取值保持一致
+    auto policy = static_cast<LogRingBuffer::OverflowPolicy>(d_ptr->overflowPolicy);
+    if (policy == LogRingBuffer::OverflowPolicy::Block && QThread::currentThread() == this) {
+        policy = LogRingBuffer::OverflowPolicy::DropNewest; // 日志线程不能等待自己
+    }
+
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    d_ptr->ringBuffer->push(logRecordOverhead(record) + encoder.requiredSpace(msg.size()),
+                            policy,
+                            [&encoder, &record, msg](char *dst) -> qsizetype {
+                                auto *end = encodeLogRecordPrefix(dst, record);
+                                end = encoder.appendToBuffer(end, msg);
+                                finishLogRecord(dst, end);
+                                return end - dst;
+                            });
+    d_ptr->scheduleDrain();
+}
+
+auto LogAsync::flushAndWait(int timeoutMs) -> bool
+{
+    if (!isRunning()) {
+        return false;
+    }
+
+    // 崩溃时持有该锁的线程可能已经停止，不能无限等待
+    if (!d_ptr->logFileMutex.tryLock(timeoutMs)) {
+        return false;
+    }
+    auto *file = d_ptr->logFile;
+    if (file == nullptr) {
+        d_ptr->logFileMutex.unlock();
+        return false;
+    }
+    if (QThread::currentThread() == this) {
+        d_ptr->logFileMutex.unlock();
+        d_ptr->drain(file);
+        file->sync();
+        return true;
+    }
+
+    auto done = std::make_shared<QSemaphore>();
+    QMetaObject::invokeMethod(
+        file,
+        [this, file, done] {
+            d_ptr->drain(file);
+            file->sync();
+            done->release();
+        },
+        Qt::QueuedConnection);
+    d_ptr->logFileMutex.unlock();
+    return done->tryAcquire(1, timeoutMs);
+}
+
 void LogAsync::startWork()
 {
+    if (!d_ptr->ringBuffer) {
+        d_ptr->ringBuffer = std::make_unique<LogRingBuffer>(d_ptr->bufferCapacity,
+                                                            d_ptr->bufferSlotSize);
+    }
     start();
     d_ptr->semaphore.acquire(); // 等待线程启动完成
 }
 
 void LogAsync::stop()
 {
-    if (isRunning()) { // 可能有部分日志未写入文件，异步信号槽机制问题
+    if (isRunning()) { // 退出前 run() 会取空缓冲区中剩余的日志
+        d_ptr->running.store(false, std::memory_order_release);
         quit();
         wait();
     }
@@ -178,9 +460,21 @@ void LogAsync::stop()
 void LogAsync::run()
 {
     LogFile logFile;
-    connect(this, &LogAsync::appendBuf, &logFile, &LogFile::onWrite);
+    {
+        QMutexLocker locker(&d_ptr->logFileMutex);
+        d_ptr->logFile = &logFile;
+    }
+    d_ptr->drainPending.store(false, std::memory_order_release);
+    d_ptr->running.store(true, std::memory_order_release);
     d_ptr->semaphore.release();
+
     exec();
+
+    {
+        QMutexLocker locker(&d_ptr->logFileMutex);
+        d_ptr->logFile = nullptr;
+    }
+    d_ptr->drain(&logFile);
 }
 
 LogAsync::LogAsync(QObject *parent)
@@ -188,12 +482,18 @@ LogAsync::LogAsync(QObject *parent)
     , d_ptr(new LogAsyncPrivate(this))
 {
     qInstallMessageHandler(messageHandler);
+    // 此时单例尚未构造完成，过滤器不能通过 instance() 访问
+    LogAsyncPrivate::filterInstance = d_ptr.data();
+    LogAsyncPrivate::previousCategoryFilter = QLoggingCategory::installFilter(
+        &LogAsyncPrivate::categoryFilter);
 }
 
 LogAsync::~LogAsync()
 {
     stop();
     qInstallMessageHandler(nullptr);
+    QLoggingCategory::installFilter(LogAsyncPrivate::previousCategoryFilter);
+    LogAsyncPrivate::filterInstance = nullptr;
     fprintf(stderr, "%s\n", "~LogAsync");
 }
 
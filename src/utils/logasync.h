@@ -1,12 +1,16 @@
 #pragma once
 
+#include <QHash>
 #include <QThread>
 
+#include "logrotation.hpp"
 #include "singleton.hpp"
 #include "utils_global.h"
 
 namespace Utils {
 
+struct LogRecord;
+
 class UTILS_EXPORT LogAsync : public QThread
 {
     Q_OBJECT
@@ -17,9 +21,23 @@ public:
         StandardAndFile = Standard | File
     };
 
+    // Text 在日志线程中渲染为文本；Binary 直接写入原始记录，由 LogDecoder 离线解码
+    enum class FileFormat : int { Text, Binary };
+
+    // Buffered 合并写入后由定时器刷新；MemoryMapped 直接追加到预分配的映射文件段，
+    // 进程崩溃时已写入映射区的日志不会丢失
+    enum class WriteMode : int { Buffered, MemoryMapped };
+
+    // 日志缓冲区写满时的处理策略
+    enum class OverflowPolicy : int { Block, DropOldest, DropNewest };
+
     void setLogPath(const QString &path);
     auto logPath() -> QString;
 
+    // 在下一次 startWork() 时生效
+    void setRotationPolicy(const LogRotationPolicy &policy);
+    auto rotationPolicy() -> LogRotationPolicy;
+
     void setAutoDelFile(bool on);
     auto autoDelFile() -> bool;
 
@@ -29,18 +47,52 @@ public:
     void setOrientation(Orientation orientation);
     auto orientation() -> Orientation;
 
+    void setFileFormat(FileFormat format);
+    auto fileFormat() -> FileFormat;
+
+    // 在下一次 startWork() 时生效
+    void setWriteMode(WriteMode mode);
+    auto writeMode() -> WriteMode;
+
+    // 每隔 ms 毫秒执行一次 fsync/msync，0 表示只交给操作系统回写
+    void setSyncInterval(int ms);
+    auto syncInterval() -> int;
+
+    // 全局级别与分类级别都通过 QLoggingCategory 过滤器生效，
+    // 被禁用的 qCDebug 等语句在构造消息、求值参数之前就会返回
     void setLogLevel(QtMsgType type);
     auto logLevel() -> QtMsgType;
 
+    // category 为 QLoggingCategory 的名称，支持 "qtc.extensionsystem.*" 形式的前缀匹配
+    void setCategoryLogLevel(const QString &category, QtMsgType type);
+    void resetCategoryLogLevel(const QString &category);
+    auto categoryLogLevels() -> QHash<QString, QtMsgType>;
+
     void setMaxConsoleLineSize(int size);
     auto maxConsoleLineSize() -> int;
 
+    void setOverflowPolicy(OverflowPolicy policy);
+    auto overflowPolicy() -> OverflowPolicy;
+
+    // 缓冲区在首次 startWork() 时分配，之后修改不再生效
+    void setBufferCapacity(int slots);
+    auto bufferCapacity() -> int;
+
+    void setBufferSlotSize(int bytes);
+    auto bufferSlotSize() -> int;
+
+    auto droppedMessages() -> quint64;
+
+    // 将一条日志的原始字段写入缓冲区，由日志线程批量写入文件
+    void append(const LogRecord &record, QStringView msg);
+
+    // 把缓冲区中已有的日志全部写入文件并落盘，最多等待 timeoutMs 毫秒；
+    // 可在任意线程中调用，但会加锁和分配内存，不能在信号处理函数或崩溃处理中调用
+    auto flushAndWait(int timeoutMs = 3000) -> bool;
+
     void startWork();
     void stop();
 
-signals:
-    void appendBuf(const QString &);
-
 protected:
     void run() override;
 
@@ -1,62 +1,237 @@
 #include "logfile.hpp"
-#include "logasync.h"
+#include "logrecord.hpp"
+#include "logrotation.hpp"
 
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDir>
+#include <QThreadPool>
 #include <QTimer>
+#include <QtConcurrent>
 
-namespace Utils {
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-#define ROLLSIZE (1000 * 1000 * 1000)
+namespace Utils {
 
-const static int g_kRollPerSeconds = 60 * 60 * 24;
+#define BUFFERSIZE (16 * 1024)
+#define MAPPEDSEGMENTSIZE (32 * 1024 * 1024)
 
-static auto getFileName(qint64 seconds) -> QString
+static auto getFileName(qint64 seconds, LogAsync::FileFormat format) -> QString
 {
     auto data = QDateTime::fromSecsSinceEpoch(seconds).toString("yyyyMMdd_hhmmss");
-    auto filename = QString("%1/%2_%3_%4_%5_%6.log")
+    const QString suffix = format == LogAsync::FileFormat::Binary ? "blog" : "log";
+    auto filename = QString("%1/%2_%3_%4_%5_%6.%7")
                         .arg(LogAsync::instance()->logPath(),
                              qAppName(),
                              qApp->applicationVersion(),
                              data,
                              QSysInfo::machineHostName(),
-                             QString::number(qApp->applicationPid()));
+                             QString::number(qApp->applicationPid()),
+                             suffix);
     return filename;
 }
 
-static void autoDelFile()
+class LogFile::LogFilePrivate
 {
-    auto *instance = LogAsync::instance();
-    const auto path(instance->logPath());
-    QDir dir(path);
-    if (!dir.exists()) {
-        return;
+public:
+    explicit LogFilePrivate(LogFile *q)
+        : q_ptr(q)
+    {
+        compressPool.setMaxThreadCount(1);
     }
 
-    const auto list = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Time);
-    const auto cur = QDateTime::currentDateTime();
-    const auto pre = cur.addDays(-instance->autoDelFileDays());
+    auto periodStart(qint64 seconds) const -> qint64
+    {
+        return policy.period > 0 ? seconds / policy.period * policy.period : 0;
+    }
 
-    for (const auto &info : std::as_const(list)) {
-        if (info.lastModified() <= pre) {
-            dir.remove(info.fileName());
+    void archive(const QString &filePath, qint64 size, qint64 modified)
+    {
+        if (!policy.compress || size == 0) {
+            logArchive.add(filePath, size, modified);
+            return;
         }
+        logArchive.add(filePath, size, modified, true);
+        const auto target = filePath + ".gz";
+        QtConcurrent::run(&compressPool, gzipLogFile, filePath, target)
+            .then(q_ptr, [this, filePath, target, size](bool ok) {
+                if (ok) {
+                    logArchive.replace(filePath, target, QFileInfo(target).size());
+                } else {
+                    logArchive.replace(filePath, filePath, size);
+                }
+            });
     }
-}
 
-class LogFile::LogFilePrivate
-{
-public:
-    explicit LogFilePrivate(LogFile *q)
-        : q_ptr(q)
-    {}
+    auto openFile(const QString &filename) -> bool
+    {
+        const auto mapped = writeMode == LogAsync::WriteMode::MemoryMapped;
+        // 映射写入需要可读，追加位置由 fileSize 自行维护
+        const auto mode = mapped ? QIODevice::ReadWrite
+                                 : QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered;
+        file.setFileName(filename);
+        if (!file.open(mode)) {
+            return false;
+        }
+        fileSize = file.size();
+        syncedSize = fileSize;
+        if (format == LogAsync::FileFormat::Binary && fileSize == 0) {
+            append(binaryLogFileHeader());
+        }
+        return true;
+    }
+
+    void closeFile()
+    {
+        if (!file.isOpen()) {
+            return;
+        }
+        flushBuffer();
+        unmapSegment();
+        if (file.size() != fileSize) {
+            file.resize(fileSize); // 截掉预分配但未写入的部分
+        }
+        file.close();
+    }
+
+    void append(QByteArrayView data)
+    {
+        if (writeMode == LogAsync::WriteMode::Buffered) {
+            buffer.append(data);
+            if (buffer.size() >= BUFFERSIZE) {
+                flushBuffer();
+            }
+            return;
+        }
+        if (mapped == nullptr || fileSize + data.size() > mappedOffset + mappedSize) {
+            if (!mapSegment(data.size())) {
+                return;
+            }
+        }
+        memcpy(mapped + (fileSize - mappedOffset), data.data(), data.size());
+        fileSize += data.size();
+    }
+
+    void flushBuffer()
+    {
+        if (buffer.isEmpty() || !file.isOpen()) {
+            return;
+        }
+        const auto written = file.write(buffer);
+        if (written > 0) {
+            fileSize += written;
+        }
+        buffer.resize(0); // 保留已分配的容量
+    }
+
+    // 预分配并映射从 fileSize 开始的下一段文件
+    auto mapSegment(qsizetype minSize) -> bool
+    {
+        unmapSegment();
+        const auto size = qMax<qint64>(MAPPEDSEGMENTSIZE, minSize);
+        if (!file.resize(fileSize + size)) {
+            return false;
+        }
+        mapped = file.map(fileSize, size);
+        if (mapped == nullptr) {
+            file.resize(fileSize);
+            return false;
+        }
+        mappedOffset = fileSize;
+        mappedSize = size;
+        return true;
+    }
+
+    void unmapSegment()
+    {
+        if (mapped == nullptr) {
+            return;
+        }
+        syncMapped(true);
+        file.unmap(mapped);
+        mapped = nullptr;
+        mappedOffset = 0;
+        mappedSize = 0;
+    }
+
+    void syncMapped(bool async)
+    {
+        const auto begin = qMax(syncedSize, mappedOffset);
+        if (mapped == nullptr || fileSize <= begin) {
+            return;
+        }
+        // msync/FlushViewOfFile 要求起始地址按页对齐
+        static const auto pageSize = [] {
+#ifdef Q_OS_WIN
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return quintptr(info.dwAllocationGranularity);
+#else
+            return quintptr(sysconf(_SC_PAGESIZE));
+#endif
+        }();
+        const auto address = reinterpret_cast<quintptr>(mapped + (begin - mappedOffset));
+        const auto aligned = address & ~(pageSize - 1);
+        const auto length = size_t(fileSize - begin) + (address - aligned);
+#ifdef Q_OS_WIN
+        FlushViewOfFile(reinterpret_cast<void *>(aligned), length);
+        if (!async) {
+            FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file.handle())));
+        }
+#else
+        msync(reinterpret_cast<void *>(aligned), length, async ? MS_ASYNC : MS_SYNC);
+#endif
+        syncedSize = fileSize;
+    }
+
+    void sync()
+    {
+        if (!file.isOpen()) {
+            return;
+        }
+        if (writeMode == LogAsync::WriteMode::MemoryMapped) {
+            syncMapped(false);
+            return;
+        }
+        flushBuffer();
+#ifdef Q_OS_WIN
+        _commit(file.handle());
+#else
+        fsync(file.handle());
+#endif
+        syncedSize = fileSize;
+    }
+
+    void enforceRetention()
+    {
+        auto *instance = LogAsync::instance();
+        const auto maxAge = instance->autoDelFile() ? instance->autoDelFileDays() * 24 * 60 * 60
+                                                    : 0;
+        logArchive.enforce(policy, maxAge, fileSize);
+    }
 
     LogFile *q_ptr;
 
     QFile file;
-    //QTextStream 读写分离的，内部有缓冲区static const int QTEXTSTREAM_BUFFERSIZE = 16384;
-    QTextStream stream;
+    // Buffered 模式下合并多条消息后一次写入，文件本身以 Unbuffered 方式打开
+    QByteArray buffer;
+    qint64 fileSize = 0;
+    qint64 syncedSize = 0;
+    // MemoryMapped 模式下直接追加到映射区，进程崩溃时已写入的内容仍在页缓存中
+    uchar *mapped = nullptr;
+    qint64 mappedOffset = 0;
+    qint64 mappedSize = 0;
+    LogAsync::FileFormat format = LogAsync::instance()->fileFormat();
+    LogAsync::WriteMode writeMode = LogAsync::instance()->writeMode();
+    LogRotationPolicy policy = LogAsync::instance()->rotationPolicy();
+    LogArchive logArchive;
+    QThreadPool compressPool;
     qint64 startTime = 0;
     qint64 lastRoll = 0;
     int count = 0;
@@ -66,62 +241,73 @@ LogFile::LogFile(QObject *parent)
     : QObject(parent)
     , d_ptr(new LogFilePrivate(this))
 {
+    d_ptr->logArchive.scan(LogAsync::instance()->logPath());
     rollFile(0);
     setTimer();
 }
 
 LogFile::~LogFile()
 {
-    onFlush();
+    d_ptr->closeFile();
+    d_ptr->compressPool.waitForDone();
 }
 
-void LogFile::onWrite(const QString &msg)
+auto LogFile::format() const -> LogAsync::FileFormat
 {
-    if (d_ptr->file.size() > ROLLSIZE) {
+    return d_ptr->format;
+}
+
+void LogFile::write(QByteArrayView msg)
+{
+    if (d_ptr->fileSize + d_ptr->buffer.size() > d_ptr->policy.maxFileSize) {
         rollFile(++d_ptr->count);
-    } else {
-        qint64 now = QDateTime::currentSecsSinceEpoch();
-        qint64 thisPeriod = now / g_kRollPerSeconds * g_kRollPerSeconds;
+    } else if (d_ptr->policy.period > 0) {
+        qint64 thisPeriod = d_ptr->periodStart(QDateTime::currentSecsSinceEpoch());
         if (thisPeriod != d_ptr->startTime) {
             d_ptr->count = 0;
             rollFile(0);
         }
     }
 
-    d_ptr->stream << msg;
+    if (d_ptr->file.isOpen()) {
+        d_ptr->append(msg);
+    }
+}
+
+void LogFile::sync()
+{
+    d_ptr->sync();
 }
 
 void LogFile::onFlush()
 {
-    d_ptr->stream.flush();
+    if (d_ptr->writeMode == LogAsync::WriteMode::MemoryMapped) {
+        d_ptr->syncMapped(true);
+        return;
+    }
+    d_ptr->flushBuffer();
 }
 
 auto LogFile::rollFile(int count) -> bool
 {
     qint64 now = QDateTime::currentSecsSinceEpoch();
-    QString filename = getFileName(now);
+    QString filename = getFileName(now, d_ptr->format);
     if (count != 0) {
         filename += QString(".%1").arg(count);
-    } else if (LogAsync::instance()->autoDelFile()) {
-        autoDelFile();
     }
-    qint64 start = now / g_kRollPerSeconds * g_kRollPerSeconds;
     if (now > d_ptr->lastRoll) {
-        d_ptr->startTime = start;
+        d_ptr->startTime = d_ptr->periodStart(now);
         d_ptr->lastRoll = now;
         if (d_ptr->file.isOpen()) {
-            d_ptr->file.flush();
-            d_ptr->file.close();
+            d_ptr->closeFile();
+            d_ptr->archive(d_ptr->file.fileName(), d_ptr->fileSize, now);
         }
-        d_ptr->file.setFileName(filename);
-        auto ret = d_ptr->file.open(QIODevice::WriteOnly | QIODevice::Append
-                                    | QIODevice::Unbuffered);
-        if (!ret) {
+        if (!d_ptr->openFile(filename)) {
             qWarning() << "Failed to open log file:" << filename
                        << "Error:" << d_ptr->file.errorString();
             return false;
         }
-        d_ptr->stream.setDevice(&d_ptr->file);
+        d_ptr->enforceRetention();
         fprintf(stderr, "%s\n", filename.toUtf8().constData());
         return true;
     }
@@ -133,6 +319,13 @@ void LogFile::setTimer()
     auto *timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &LogFile::onFlush);
     timer->start(5000); // 5秒刷新一次
+
+    const auto syncInterval = LogAsync::instance()->syncInterval();
+    if (syncInterval > 0) {
+        auto *syncTimer = new QTimer(this);
+        connect(syncTimer, &QTimer::timeout, this, &LogFile::sync);
+        syncTimer->start(syncInterval);
+    }
 }
 
 } // namespace Utils
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "logasync.h"
+
 #include <QObject>
 
 namespace Utils {
@@ -11,10 +13,13 @@ public:
     explicit LogFile(QObject *parent = nullptr);
     ~LogFile() override;
 
-public slots:
-    void onWrite(const QString &msg);
+    auto format() const -> LogAsync::FileFormat;
 
-private slots:
+    void write(QByteArrayView msg);
+    // 写入并落盘（fsync/msync）所有已接收的日志
+    void sync();
+
+public slots:
     void onFlush();
 
 private:
@@ -0,0 +1,154 @@
+#include "logrecord.hpp"
+
+#include <QDateTime>
+
+#include <cstddef>
+#include <cstring>
+
+namespace Utils {
+
+namespace {
+
+// 以本机字节序写入，文件头中的 byteOrderMark 用于解码时校验
+struct RecordHeader
+{
+    quint32 size;
+    qint32 line;
+    qint64 timestamp;
+    quint64 threadId;
+    quint16 categorySize;
+    quint16 fileSize;
+    quint8 type;
+    quint8 reserved[3];
+};
+static_assert(sizeof(RecordHeader) == 32);
+
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+const quint32 g_kByteOrderMark = 0x01020304;
+
+auto clampedSize(QByteArrayView view) -> quint16
+{
+    return static_cast<quint16>(qMin<qsizetype>(view.size(), 0xFFFF));
+}
+
+} // namespace
+
+auto binaryLogFileHeader() -> QByteArray
+{
+    FileHeader header;
+    memcpy(header.magic, kBinaryLogMagic, sizeof(header.magic));
+    header.version = kBinaryLogVersion;
+    header.byteOrderMark = g_kByteOrderMark;
+    return QByteArray(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+auto isBinaryLogFileHeader(QByteArrayView data) -> bool
+{
+    if (data.size() < qsizetype(sizeof(FileHeader))) {
+        return false;
+    }
+    FileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    return memcmp(header.magic, kBinaryLogMagic, sizeof(header.magic)) == 0
+           && header.version == kBinaryLogVersion && header.byteOrderMark == g_kByteOrderMark;
+}
+
+auto binaryLogFileHeaderSize() -> qsizetype
+{
+    return sizeof(FileHeader);
+}
+
+auto logRecordOverhead(const LogRecord &record) -> qsizetype
+{
+    return sizeof(RecordHeader) + clampedSize(record.category) + clampedSize(record.file);
+}
+
+auto encodeLogRecordPrefix(char *dst, const LogRecord &record) -> char *
+{
+    RecordHeader header{};
+    header.line = record.line;
+    header.timestamp = record.timestamp;
+    header.threadId = record.threadId;
+    header.categorySize = clampedSize(record.category);
+    header.fileSize = clampedSize(record.file);
+    header.type = static_cast<quint8>(record.type);
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    memcpy(dst, record.category.data(), header.categorySize);
+    dst += header.categorySize;
+    memcpy(dst, record.file.data(), header.fileSize);
+    return dst + header.fileSize;
+}
+
+void finishLogRecord(char *begin, char *end)
+{
+    const auto size = static_cast<quint32>(end - begin);
+    memcpy(begin + offsetof(RecordHeader, size), &size, sizeof(size));
+}
+
+auto decodeLogRecord(QByteArrayView data, LogRecord *record) -> qsizetype
+{
+    if (data.size() < qsizetype(sizeof(RecordHeader))) {
+        return 0;
+    }
+    RecordHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    const qsizetype prefixSize = sizeof(RecordHeader) + header.categorySize + header.fileSize;
+    if (header.size < prefixSize || header.size > data.size()) {
+        return 0;
+    }
+
+    const char *p = data.data() + sizeof(RecordHeader);
+    record->timestamp = header.timestamp;
+    record->threadId = header.threadId;
+    record->type = static_cast<QtMsgType>(header.type);
+    record->line = header.line;
+    record->category = QByteArrayView(p, header.categorySize);
+    p += header.categorySize;
+    record->file = QByteArrayView(p, header.fileSize);
+    p += header.fileSize;
+    record->message = QByteArrayView(p, header.size - prefixSize);
+    return header.size;
+}
+
+auto logLevelName(QtMsgType type) -> QString
+{
+    switch (type) {
+    case QtDebugMsg: return QString("%1").arg("Debug", -7);
+    case QtWarningMsg: return QString("%1").arg("Warning", -7);
+    case QtCriticalMsg: return QString("%1").arg("Critica", -7);
+    case QtFatalMsg: return QString("%1").arg("Fatal", -7);
+    case QtInfoMsg: return QString("%1").arg("Info", -7);
+    default: break;
+    }
+    return QString("%1").arg("Unknown", -7);
+}
+
+auto formatLogRecord(const LogRecord &record, const QString &message) -> QString
+{
+    const auto dataTimeString(
+        QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("yyyy-MM-dd hh:mm:ss.zzz"));
+    const auto threadId = QString("%1").arg(record.threadId, 5, 10, QLatin1Char('0'));
+    QString contexInfo;
+    if (!record.file.isEmpty()) {
+        contexInfo = QString("File:(%1) Line:(%2)")
+                         .arg(QString::fromUtf8(record.file))
+                         .arg(record.line);
+    }
+    return QString("%1 %2 [%3] %4 - %5\n")
+        .arg(dataTimeString, threadId, logLevelName(record.type), message, contexInfo);
+}
+
+auto formatLogRecord(const LogRecord &record) -> QString
+{
+    return formatLogRecord(record, QString::fromUtf8(record.message));
+}
+
+} // namespace Utils
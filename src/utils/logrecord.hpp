@@ -0,0 +1,47 @@
+#pragma once
+
+#include "utils_global.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+namespace Utils {
+
+// 二进制日志中的一条记录：固定长度的记录头 + category + file + UTF-8 消息。
+// 调用线程只负责填写原始字段，时间格式化等工作推迟到日志线程或离线解码工具。
+struct UTILS_EXPORT LogRecord
+{
+    qint64 timestamp = 0; // 毫秒，自 1970-01-01T00:00:00 UTC 起
+    quint64 threadId = 0;
+    QtMsgType type = QtDebugMsg;
+    int line = 0;
+    QByteArrayView category;
+    QByteArrayView file;
+    QByteArrayView message; // UTF-8
+};
+
+// 每个二进制日志文件开头的文件头
+inline constexpr char kBinaryLogMagic[8] = {'Q', 'A', 'P', 'P', 'B', 'L', 'O', 'G'};
+inline constexpr quint32 kBinaryLogVersion = 1;
+
+UTILS_EXPORT auto binaryLogFileHeader() -> QByteArray;
+UTILS_EXPORT auto isBinaryLogFileHeader(QByteArrayView data) -> bool;
+UTILS_EXPORT auto binaryLogFileHeaderSize() -> qsizetype;
+
+// 记录头与各变长字段（消息除外）所需的字节数
+UTILS_EXPORT auto logRecordOverhead(const LogRecord &record) -> qsizetype;
+// 写入记录头、category 与 file，返回消息应写入的位置
+UTILS_EXPORT auto encodeLogRecordPrefix(char *dst, const LogRecord &record) -> char *;
+// 在消息写完后回填记录的总长度
+UTILS_EXPORT void finishLogRecord(char *begin, char *end);
+
+// 从 data 的开头解析一条记录，成功时返回记录占用的字节数，数据不完整或损坏时返回 0
+UTILS_EXPORT auto decodeLogRecord(QByteArrayView data, LogRecord *record) -> qsizetype;
+
+UTILS_EXPORT auto logLevelName(QtMsgType type) -> QString;
+// 渲染为文本日志中的一行；第一个重载忽略 record.message，使用调用者给出的消息
+UTILS_EXPORT auto formatLogRecord(const LogRecord &record, const QString &message) -> QString;
+UTILS_EXPORT auto formatLogRecord(const LogRecord &record) -> QString;
+
+} // namespace Utils
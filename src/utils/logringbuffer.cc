@@ -0,0 +1,101 @@
+#include "logringbuffer.hpp"
+
+#include <QThread>
+
+namespace Utils {
+
+static auto roundUpToPowerOfTwo(qsizetype value) -> qsizetype
+{
+    qsizetype result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+LogRingBuffer::LogRingBuffer(qsizetype capacity, qsizetype slotSize)
+    : m_mask(roundUpToPowerOfTwo(capacity) - 1)
+    , m_slotSize(qMax<qsizetype>(slotSize, 1))
+    , m_slots(new Slot[m_mask + 1])
+    , m_storage(new char[(m_mask + 1) * m_slotSize])
+{
+    for (qsizetype i = 0; i <= m_mask; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        m_slots[i].data = m_storage.get() + i * m_slotSize;
+    }
+}
+
+LogRingBuffer::~LogRingBuffer() = default;
+
+auto LogRingBuffer::isEmpty() const -> bool
+{
+    return m_dequeuePos.load(std::memory_order_acquire)
+           == m_enqueuePos.load(std::memory_order_acquire);
+}
+
+auto LogRingBuffer::tryClaim(size_t &pos) -> Slot *
+{
+    pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        auto *slot = &m_slots[pos & m_mask];
+        const auto seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<qint64>(seq) - static_cast<qint64>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return slot;
+            }
+        } else if (diff < 0) {
+            return nullptr; // 已满
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto LogRingBuffer::tryConsume(size_t &pos) -> Slot *
+{
+    pos = m_dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        auto *slot = &m_slots[pos & m_mask];
+        const auto seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<qint64>(seq) - static_cast<qint64>(pos + 1);
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return slot;
+            }
+        } else if (diff < 0) {
+            return nullptr; // 为空，或生产者尚未写完
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogRingBuffer::release(Slot *slot, size_t pos)
+{
+    if (slot->inOverflow) {
+        slot->overflow.clear(); // 超长消息的内存不常驻
+        slot->inOverflow = false;
+    }
+    slot->size = 0;
+    slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+}
+
+void LogRingBuffer::discardOldest()
+{
+    size_t pos = 0;
+    if (auto *slot = tryConsume(pos)) {
+        release(slot, pos);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // 最旧的槽位仍在被其他生产者写入，让出时间片后重试
+        backoff();
+    }
+}
+
+void LogRingBuffer::backoff()
+{
+    QThread::yieldCurrentThread();
+}
+
+} // namespace Utils
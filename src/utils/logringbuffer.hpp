@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+namespace Utils {
+
+// 有界的多生产者/单消费者环形缓冲区（Vyukov 序号算法）。
+// 每个槽位预分配 slotSize 字节，生产者直接写入槽位；超长消息才退化为堆分配。
+// DropOldest 策略下生产者会代替消费者弹出最旧的槽位，因此出队路径同样是无锁安全的。
+class LogRingBuffer
+{
+    Q_DISABLE_COPY_MOVE(LogRingBuffer)
+public:
+    enum class OverflowPolicy : int { Block, DropOldest, DropNewest };
+
+    // capacity 会向上取整为 2 的幂
+    explicit LogRingBuffer(qsizetype capacity, qsizetype slotSize);
+    ~LogRingBuffer();
+
+    auto capacity() const -> qsizetype { return m_mask + 1; }
+    auto slotSize() const -> qsizetype { return m_slotSize; }
+
+    // writer(char *dst) 最多写入 maxSize 个字节，返回实际写入的字节数
+    template<typename Writer>
+    auto push(qsizetype maxSize, OverflowPolicy policy, Writer &&writer) -> bool;
+    auto push(QByteArrayView data, OverflowPolicy policy) -> bool
+    {
+        return push(data.size(), policy, [data](char *dst) -> qsizetype {
+            memcpy(dst, data.data(), data.size());
+            return data.size();
+        });
+    }
+
+    // 仅由消费者线程调用，每条消息回调一次 reader(QByteArrayView)，返回取出的条数
+    template<typename Reader>
+    auto drain(Reader &&reader, qsizetype maxCount = -1) -> qsizetype;
+
+    auto isEmpty() const -> bool;
+    auto droppedMessages() const -> quint64 { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        qsizetype size = 0;
+        bool inOverflow = false;
+        char *data = nullptr;
+        QByteArray overflow;
+    };
+
+    auto tryClaim(size_t &pos) -> Slot *;
+    auto tryConsume(size_t &pos) -> Slot *;
+    void publish(Slot *slot, size_t pos) { slot->sequence.store(pos + 1, std::memory_order_release); }
+    void release(Slot *slot, size_t pos);
+    void discardOldest();
+    static void backoff();
+
+    qsizetype m_mask = 0;
+    qsizetype m_slotSize = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<char[]> m_storage;
+
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    alignas(64) std::atomic<quint64> m_dropped{0};
+};
+
+template<typename Writer>
+auto LogRingBuffer::push(qsizetype maxSize, OverflowPolicy policy, Writer &&writer) -> bool
+{
+    size_t pos = 0;
+    Slot *slot = nullptr;
+    while ((slot = tryClaim(pos)) == nullptr) {
+        switch (policy) {
+        case OverflowPolicy::DropNewest:
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case OverflowPolicy::DropOldest: discardOldest(); break;
+        case OverflowPolicy::Block:
+        default: backoff(); break;
+        }
+    }
+
+    char *dst = slot->data;
+    if (maxSize > m_slotSize) {
+        slot->overflow.resize(maxSize);
+        dst = slot->overflow.data();
+    }
+    slot->size = writer(dst);
+    slot->inOverflow = dst != slot->data;
+    publish(slot, pos);
+    return true;
+}
+
+template<typename Reader>
+auto LogRingBuffer::drain(Reader &&reader, qsizetype maxCount) -> qsizetype
+{
+    qsizetype count = 0;
+    size_t pos = 0;
+    while (maxCount < 0 || count < maxCount) {
+        auto *slot = tryConsume(pos);
+        if (slot == nullptr) {
+            break;
+        }
+        const char *src = slot->inOverflow ? slot->overflow.constData() : slot->data;
+        reader(QByteArrayView(src, slot->size));
+        release(slot, pos);
+        ++count;
+    }
+    return count;
+}
+
+} // namespace Utils
@@ -0,0 +1,144 @@
+#include "logrotation.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <zlib.h>
+
+#include <limits>
+
+namespace Utils {
+
+void LogArchive::scan(const QString &path)
+{
+    m_entries.clear();
+    m_totalSize = 0;
+
+    const QDir dir(path);
+    const auto list = dir.entryInfoList({"*.log*", "*.blog*"},
+                                        QDir::Files | QDir::NoDotAndDotDot,
+                                        QDir::Time | QDir::Reversed);
+    for (const auto &info : std::as_const(list)) {
+        add(info.absoluteFilePath(), info.size(), info.lastModified().toSecsSinceEpoch());
+    }
+}
+
+void LogArchive::add(const QString &filePath, qint64 size, qint64 modified, bool compressing)
+{
+    m_entries.push_back({filePath, size, modified, compressing});
+    m_totalSize += size;
+}
+
+void LogArchive::replace(const QString &filePath, const QString &newFilePath, qint64 newSize)
+{
+    for (auto &entry : m_entries) {
+        if (entry.filePath == filePath) {
+            m_totalSize += newSize - entry.size;
+            entry.filePath = newFilePath;
+            entry.size = newSize;
+            entry.compressing = false;
+            return;
+        }
+    }
+}
+
+void LogArchive::remove(const QString &filePath)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->filePath == filePath) {
+            m_totalSize -= it->size;
+            m_entries.erase(it);
+            return;
+        }
+    }
+}
+
+void LogArchive::enforce(const LogRotationPolicy &policy,
+                         qint64 maxAgeSeconds,
+                         qint64 activeFileSize)
+{
+    const auto deadline = maxAgeSeconds > 0
+                              ? QDateTime::currentSecsSinceEpoch() - maxAgeSeconds
+                              : std::numeric_limits<qint64>::min();
+    auto exceeded = [&] {
+        if (m_entries.front().modified <= deadline) {
+            return true;
+        }
+        if (policy.maxFileCount > 0 && count() + 1 > policy.maxFileCount) {
+            return true;
+        }
+        return policy.maxTotalSize > 0 && m_totalSize + activeFileSize > policy.maxTotalSize;
+    };
+
+    while (!m_entries.empty() && exceeded()) {
+        const auto &oldest = m_entries.front();
+        if (oldest.compressing) {
+            break; // 压缩完成后的下一次滚动再处理
+        }
+        if (!QFile::remove(oldest.filePath) && QFile::exists(oldest.filePath)) {
+            break;
+        }
+        m_totalSize -= oldest.size;
+        m_entries.pop_front();
+    }
+}
+
+auto gzipLogFile(const QString &source, const QString &target) -> bool
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QFile out(target);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    z_stream zs{};
+    // windowBits + 16 生成带 gzip 头的数据，可直接用 gunzip/zcat 查看
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY)
+        != Z_OK) {
+        return false;
+    }
+
+    const int chunkSize = 256 * 1024;
+    QByteArray input(chunkSize, Qt::Uninitialized);
+    QByteArray output(chunkSize, Qt::Uninitialized);
+    auto ok = true;
+    auto flush = Z_NO_FLUSH;
+    while (ok && flush != Z_FINISH) {
+        const auto size = in.read(input.data(), chunkSize);
+        if (size < 0) {
+            ok = false;
+            break;
+        }
+        flush = in.atEnd() ? Z_FINISH : Z_NO_FLUSH;
+        zs.next_in = reinterpret_cast<Bytef *>(input.data());
+        zs.avail_in = static_cast<uInt>(size);
+        do {
+            zs.next_out = reinterpret_cast<Bytef *>(output.data());
+            zs.avail_out = chunkSize;
+            deflate(&zs, flush);
+            const auto produced = chunkSize - zs.avail_out;
+            if (out.write(output.constData(), produced) != produced) {
+                ok = false;
+                break;
+            }
+        } while (zs.avail_out == 0);
+    }
+    deflateEnd(&zs);
+
+    if (!ok) {
+        out.remove();
+        return false;
+    }
+    // 保留原文件的修改时间，下次启动扫描时顺序不变
+    out.setFileTime(in.fileTime(QFileDevice::FileModificationTime),
+                    QFileDevice::FileModificationTime);
+    out.close();
+    in.close();
+    return in.remove();
+}
+
+} // namespace Utils
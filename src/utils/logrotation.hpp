@@ -0,0 +1,53 @@
+#pragma once
+
+#include "utils_global.h"
+
+#include <QString>
+
+#include <deque>
+
+namespace Utils {
+
+struct UTILS_EXPORT LogRotationPolicy
+{
+    qint64 maxFileSize = 1000 * 1000 * 1000; // 单个文件达到该字节数时滚动
+    qint64 period = 60 * 60 * 24;            // 按时间滚动的周期（秒），0 表示不按时间滚动
+    qint64 maxTotalSize = 0;                 // 日志目录的磁盘预算（字节），0 表示不限制
+    int maxFileCount = 0;                    // 保留的文件数（含当前文件），0 表示不限制
+    bool compress = false;                   // 滚动后在后台线程中压缩为 .gz
+};
+
+// 日志目录中已滚动文件的清单：启动时扫描一次，之后随滚动和压缩增量维护，
+// 按策略清理时不再重新遍历目录。只在日志线程中使用。
+class LogArchive
+{
+public:
+    void scan(const QString &path);
+
+    void add(const QString &filePath, qint64 size, qint64 modified, bool compressing = false);
+    void replace(const QString &filePath, const QString &newFilePath, qint64 newSize);
+    void remove(const QString &filePath);
+
+    // 从最旧的文件开始删除，直到满足文件年龄、数量与磁盘预算；正在压缩的文件暂不删除
+    void enforce(const LogRotationPolicy &policy, qint64 maxAgeSeconds, qint64 activeFileSize);
+
+    auto totalSize() const -> qint64 { return m_totalSize; }
+    auto count() const -> qsizetype { return qsizetype(m_entries.size()); }
+
+private:
+    struct Entry
+    {
+        QString filePath;
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool compressing = false;
+    };
+
+    std::deque<Entry> m_entries; // 按修改时间从旧到新
+    qint64 m_totalSize = 0;
+};
+
+// 以 gzip 格式压缩 source 到 target，成功后删除 source
+auto gzipLogFile(const QString &source, const QString &target) -> bool;
+
+} // namespace Utils
@@ -0,0 +1,144 @@
+#include "startuptimeline.hpp"
+#include "environment.h"
+#include "tracewriter.h"
+
+#include <QDebug>
+#include <QEvent>
+#include <QWidget>
+
+namespace Utils {
+
+namespace {
+
+struct Timeline
+{
+    QElapsedTimer clock;
+    std::shared_ptr<TraceWriter> writer;
+};
+
+// 只在主线程的启动过程中修改
+Timeline *timeline = nullptr;
+
+const char kCategory[] = "startup";
+
+class FirstPaintFilter : public QObject
+{
+public:
+    FirstPaintFilter(QWidget *widget, const char *name)
+        : QObject(widget)
+        , m_name(name)
+    {}
+
+    auto eventFilter(QObject *watched, QEvent *event) -> bool override
+    {
+        if (event->type() == QEvent::Paint && !m_done) {
+            m_done = true;
+            StartupTimeline::mark(m_name);
+            watched->removeEventFilter(this);
+            deleteLater();
+        }
+        return false;
+    }
+
+private:
+    const char *m_name;
+    bool m_done = false;
+};
+
+} // namespace
+
+void StartupTimeline::startFromEnvironment()
+{
+    const auto filePath = qtcEnvironmentVariable("QTC_STARTUP_TRACE");
+    if (!filePath.isEmpty()) {
+        start(filePath);
+    }
+}
+
+void StartupTimeline::start(const QString &filePath)
+{
+    if (timeline != nullptr) {
+        return;
+    }
+    const auto jsonFilePath = filePath.endsWith(".json") ? filePath : filePath + ".json";
+    auto writer = std::make_shared<TraceWriter>(jsonFilePath);
+    if (!writer->isOpen()) {
+        qWarning() << "Cannot open startup trace file" << jsonFilePath << writer->errorString();
+        return;
+    }
+    timeline = new Timeline;
+    timeline->clock.start();
+    timeline->writer = std::move(writer);
+    timeline->writer->instant("main", 0);
+}
+
+auto StartupTimeline::isEnabled() -> bool
+{
+    return timeline != nullptr;
+}
+
+auto StartupTimeline::clock() -> QElapsedTimer
+{
+    return timeline != nullptr ? timeline->clock : QElapsedTimer();
+}
+
+auto StartupTimeline::traceWriter() -> std::shared_ptr<TraceWriter>
+{
+    return timeline != nullptr ? timeline->writer : nullptr;
+}
+
+void StartupTimeline::begin(const char *phase)
+{
+    if (timeline == nullptr) {
+        return;
+    }
+    timeline->writer->begin(QString::fromUtf8(phase), kCategory, timeline->clock.nsecsElapsed());
+}
+
+void StartupTimeline::end(const char *phase)
+{
+    if (timeline == nullptr) {
+        return;
+    }
+    timeline->writer->end(QString::fromUtf8(phase), kCategory, timeline->clock.nsecsElapsed());
+}
+
+void StartupTimeline::mark(const char *name)
+{
+    if (timeline == nullptr) {
+        return;
+    }
+    timeline->writer->instant(QString::fromUtf8(name), timeline->clock.nsecsElapsed());
+}
+
+void StartupTimeline::markFirstPaint(QWidget *widget, const char *name)
+{
+    if (timeline == nullptr || widget == nullptr) {
+        return;
+    }
+    widget->installEventFilter(new FirstPaintFilter(widget, name));
+}
+
+void StartupTimeline::finish(const char *name)
+{
+    if (timeline == nullptr) {
+        return;
+    }
+    mark(name);
+    timeline->writer->flush();
+    delete timeline;
+    timeline = nullptr;
+}
+
+StartupPhase::StartupPhase(const char *phase)
+    : m_phase(phase)
+{
+    StartupTimeline::begin(m_phase);
+}
+
+StartupPhase::~StartupPhase()
+{
+    StartupTimeline::end(m_phase);
+}
+
+} // namespace Utils
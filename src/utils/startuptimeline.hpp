@@ -0,0 +1,52 @@
+#pragma once
+
+#include "utils_global.h"
+
+#include <QElapsedTimer>
+
+#include <memory>
+
+class QWidget;
+
+namespace Utils {
+
+class TraceWriter;
+
+// 启动时间线：记录应用启动的各个阶段，输出与插件 -trace 相同的 Chrome trace-event JSON。
+// 未启用时所有调用只检查一个指针后直接返回。
+class UTILS_EXPORT StartupTimeline
+{
+public:
+    // 环境变量 QTC_STARTUP_TRACE 指定输出文件时启用，应在 main() 的最开始调用
+    static void startFromEnvironment();
+    static void start(const QString &filePath);
+    static auto isEnabled() -> bool;
+
+    // 时间线的时钟，插件管理器以它为基准，使两部分事件位于同一时间轴上
+    static auto clock() -> QElapsedTimer;
+    static auto traceWriter() -> std::shared_ptr<TraceWriter>;
+
+    static void begin(const char *phase);
+    static void end(const char *phase);
+    static void mark(const char *name);
+    // widget 第一次收到绘制事件时记录 name
+    static void markFirstPaint(QWidget *widget, const char *name);
+
+    // 记录 name 并结束时间线，文件在最后一个使用者释放 TraceWriter 时关闭
+    static void finish(const char *name);
+};
+
+// 作用域内的启动阶段
+class UTILS_EXPORT StartupPhase
+{
+public:
+    explicit StartupPhase(const char *phase);
+    ~StartupPhase();
+
+private:
+    Q_DISABLE_COPY_MOVE(StartupPhase)
+
+    const char *m_phase;
+};
+
+} // namespace Utils
@@ -0,0 +1,123 @@
+#include "tracewriter.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QThread>
+
+namespace Utils {
+
+static double toMicroseconds(qint64 ns)
+{
+    return ns / 1000.0;
+}
+
+TraceWriter::TraceWriter(const QString &filePath)
+    : m_file(filePath)
+{
+    if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        m_file.write("[\n");
+}
+
+TraceWriter::~TraceWriter()
+{
+    if (m_file.isOpen())
+        m_file.write("\n]\n");
+}
+
+void TraceWriter::begin(const QString &name, const QString &category, qint64 timestampNs)
+{
+    QMutexLocker locker(&m_mutex);
+    const int tid = threadTrack();
+    m_openSlices.insert(QString::number(tid) + '\n' + category + '\n' + name, timestampNs);
+}
+
+void TraceWriter::end(const QString &name,
+                      const QString &category,
+                      qint64 timestampNs,
+                      const QJsonObject &args)
+{
+    QMutexLocker locker(&m_mutex);
+    const int tid = threadTrack();
+    const auto it = m_openSlices.find(QString::number(tid) + '\n' + category + '\n' + name);
+    if (it == m_openSlices.end())
+        return;
+    const qint64 start = *it;
+    m_openSlices.erase(it);
+
+    QJsonObject event;
+    event["name"] = name;
+    event["cat"] = category;
+    event["ph"] = "X";
+    event["ts"] = toMicroseconds(start);
+    event["dur"] = toMicroseconds(timestampNs - start);
+    if (!args.isEmpty())
+        event["args"] = args;
+    writeEvent(event, tid);
+}
+
+void TraceWriter::counter(const QString &name, qint64 timestampNs, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonObject event;
+    event["name"] = name;
+    event["ph"] = "C";
+    event["ts"] = toMicroseconds(timestampNs);
+    event["args"] = QJsonObject{{"count", value}};
+    writeEvent(event, threadTrack());
+}
+
+void TraceWriter::instant(const QString &name, qint64 timestampNs)
+{
+    QMutexLocker locker(&m_mutex);
+    QJsonObject event;
+    event["name"] = name;
+    event["ph"] = "i";
+    event["s"] = "p";
+    event["ts"] = toMicroseconds(timestampNs);
+    writeEvent(event, threadTrack());
+}
+
+void TraceWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    m_file.flush();
+}
+
+int TraceWriter::threadTrack()
+{
+    const auto id = quintptr(QThread::currentThreadId());
+    const auto it = m_threadTracks.constFind(id);
+    if (it != m_threadTracks.cend())
+        return *it;
+
+    const int tid = m_threadTracks.size() + 1;
+    m_threadTracks.insert(id, tid);
+
+    QString threadName = QThread::currentThread()->objectName();
+    if (threadName.isEmpty()) {
+        const bool isMainThread = QCoreApplication::instance()
+                                  && QThread::currentThread()
+                                         == QCoreApplication::instance()->thread();
+        threadName = isMainThread ? QString("Main Thread") : QString("Thread %1").arg(tid);
+    }
+    QJsonObject metadata;
+    metadata["name"] = "thread_name";
+    metadata["ph"] = "M";
+    metadata["args"] = QJsonObject{{"name", threadName}};
+    writeEvent(metadata, tid);
+    return tid;
+}
+
+void TraceWriter::writeEvent(QJsonObject event, int tid)
+{
+    if (!m_file.isOpen())
+        return;
+    event["pid"] = QCoreApplication::applicationPid();
+    event["tid"] = tid;
+    if (!m_firstEvent)
+        m_file.write(",\n");
+    m_firstEvent = false;
+    m_file.write(QJsonDocument(event).toJson(QJsonDocument::Compact));
+}
+
+} // namespace Utils
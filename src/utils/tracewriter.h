@@ -0,0 +1,46 @@
+#pragma once
+
+#include "utils_global.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+
+namespace Utils {
+
+// Writes Chrome/Perfetto trace-event JSON (array format). Timestamps are
+// nanoseconds on a clock chosen by the caller, e.g. the plugin manager's
+// profiling timer. Thread safe.
+class UTILS_EXPORT TraceWriter
+{
+public:
+    explicit TraceWriter(const QString &filePath);
+    ~TraceWriter();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+    QString filePath() const { return m_file.fileName(); }
+
+    // Emits one complete ("X") event per begin()/end() pair on the calling thread.
+    void begin(const QString &name, const QString &category, qint64 timestampNs);
+    void end(const QString &name,
+             const QString &category,
+             qint64 timestampNs,
+             const QJsonObject &args = {});
+    void counter(const QString &name, qint64 timestampNs, qint64 value);
+    void instant(const QString &name, qint64 timestampNs);
+    void flush();
+
+private:
+    int threadTrack(); // Must be called with m_mutex held.
+    void writeEvent(QJsonObject event, int tid);
+
+    QMutex m_mutex;
+    QFile m_file;
+    bool m_firstEvent = true;
+    QHash<quintptr, int> m_threadTracks;
+    QHash<QString, qint64> m_openSlices;
+};
+
+} // namespace Utils
@@ -19,7 +19,7 @@ void setUTF8Code()
     QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
 }
 
-void setQSS(const QStringList &qssFilePaths)
+auto readQSS(const QStringList &qssFilePaths) -> QString
 {
     QStringList qssFiles;
     for (const auto &path : std::as_const(qssFilePaths)) {
@@ -32,31 +32,57 @@ void setQSS(const QStringList &qssFilePaths)
         qssFiles.append(QLatin1String(file.readAll()));
         file.close();
     }
-    if (qssFiles.isEmpty()) {
+    return qssFiles.join("\n");
+}
+
+void setQSS(const QStringList &qssFilePaths)
+{
+    const auto qss = readQSS(qssFilePaths);
+    if (qss.isEmpty()) {
         return;
     }
-    qApp->setStyleSheet(qssFiles.join("\n"));
+    qApp->setStyleSheet(qss);
 }
 
-void loadFonts(const QString &fontPath)
+auto readFonts(const QString &fontPath) -> QList<FontFile>
 {
     const QDir dir(fontPath);
     if (!dir.exists()) {
-        return;
+        return {};
     }
-    // QFontDatabase::removeAllApplicationFonts();
+    QList<FontFile> fontFiles;
     const auto fonts = dir.entryInfoList(QStringList("*.ttf"), QDir::Files);
     for (const auto &fileInfo : std::as_const(fonts)) {
-        int fontId = QFontDatabase::addApplicationFont(fileInfo.absoluteFilePath());
+        QFile file(fileInfo.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << QString("Loading Fonts file: %1 Failed.").arg(fileInfo.fileName())
+                       << file.errorString();
+            continue;
+        }
+        fontFiles.append({fileInfo.fileName(), file.readAll()});
+    }
+    return fontFiles;
+}
+
+void addApplicationFonts(const QList<FontFile> &fontFiles)
+{
+    // QFontDatabase::removeAllApplicationFonts();
+    for (const auto &fontFile : std::as_const(fontFiles)) {
+        int fontId = QFontDatabase::addApplicationFontFromData(fontFile.data);
         if (fontId == -1) {
-            qWarning() << QString("Loading Fonts file: %1 Failed.").arg(fileInfo.fileName());
+            qWarning() << QString("Loading Fonts file: %1 Failed.").arg(fontFile.fileName);
         } else {
-            qInfo() << QString("Loading Fonts file: %1.").arg(fileInfo.fileName())
+            qInfo() << QString("Loading Fonts file: %1.").arg(fontFile.fileName)
                     << QFontDatabase::applicationFontFamilies(fontId);
         }
     }
 }
 
+void loadFonts(const QString &fontPath)
+{
+    addApplicationFonts(readFonts(fontPath));
+}
+
 void windowCenter(QWidget *child, QWidget *parent)
 {
     const QSize size = parent->size() - child->size();
@@ -386,7 +412,7 @@ double cpuBenchOnce(int durationMs, QCryptographicHash::Algorithm algorithm, con
     QElapsedTimer timer;
     timer.start();
 
-    int totalBytes = 0;
+    qint64 totalBytes = 0; // int 在较快的机器上一秒内就会溢出
     volatile char dummy = 0; // 防止编译器优化
 
     while (timer.elapsed() < durationMs) {
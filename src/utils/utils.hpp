@@ -19,6 +19,12 @@ struct UTILS_EXPORT DirectoryStats
 };
 UTILS_EXPORT auto calculateDirectoryStats(const QString &path) -> DirectoryStats;
 
+struct UTILS_EXPORT FontFile
+{
+    QString fileName;
+    QByteArray data;
+};
+
 UTILS_EXPORT auto configLocation() -> QString;
 UTILS_EXPORT auto configPath() -> QString;
 UTILS_EXPORT auto configFilePath() -> QString;
@@ -32,8 +38,12 @@ UTILS_EXPORT auto systemInfo() -> QString;
 UTILS_EXPORT void setHighDpiEnvironmentVariable();
 UTILS_EXPORT void quitApplication();
 UTILS_EXPORT void setUTF8Code();
+// readQSS 和 readFonts 只读取文件，可以在工作线程中调用；其余需要在主线程中调用
+UTILS_EXPORT auto readQSS(const QStringList &qssFilePaths) -> QString;
 UTILS_EXPORT void setQSS(const QStringList &qssFilePaths);
 UTILS_EXPORT void setPixmapCacheLimit();
+UTILS_EXPORT auto readFonts(const QString &fontPath) -> QList<FontFile>;
+UTILS_EXPORT void addApplicationFonts(const QList<FontFile> &fontFiles);
 UTILS_EXPORT void loadFonts(const QString &fontPath);
 UTILS_EXPORT void windowCenter(QWidget *child, QWidget *parent);
 UTILS_EXPORT void windowCenter(QWidget *window);
@@ -28,6 +28,7 @@ SOURCES += \
     categorysortfiltermodel.cpp \
     commandline.cpp \
     completinglineedit.cpp \
+    cpubench.cc \
     devicefileaccess.cpp \
     elidinglabel.cpp \
     environment.cpp \
@@ -48,6 +49,9 @@ SOURCES += \
     layoutbuilder.cpp \
     logasync.cpp \
     logfile.cc \
+    logrecord.cc \
+    logringbuffer.cc \
+    logrotation.cc \
     macroexpander.cpp \
     multitextcursor.cpp \
     namevaluedictionary.cpp \
@@ -62,6 +66,7 @@ SOURCES += \
     savefile.cpp \
     shutdownguard.cpp \
     singletonmanager.cc \
+    startuptimeline.cc \
     store.cpp \
     stringutils.cpp \
     stylehelper.cpp \
@@ -69,6 +74,7 @@ SOURCES += \
     temporaryfile.cpp \
     textcodec.cpp \
     threadutils.cpp \
+    tracewriter.cpp \
     treemodel.cpp \
     utils.cc \
     utilsicons.cpp \
@@ -85,6 +91,7 @@ HEADERS += \
     categorysortfiltermodel.h \
     commandline.h \
     completinglineedit.h \
+    cpubench.hpp \
     devicefileaccess.h \
     elidinglabel.h \
     environment.h \
@@ -109,6 +116,9 @@ HEADERS += \
     layoutbuilder.h \
     logasync.h \
     logfile.hpp \
+    logrecord.hpp \
+    logringbuffer.hpp \
+    logrotation.hpp \
     macroexpander.h \
     mimeutils.h \
     multitextcursor.h \
@@ -129,6 +139,7 @@ HEADERS += \
     shutdownguard.h \
     singleton.hpp \
     singletonmanager.hpp \
+    startuptimeline.hpp \
     store.h \
     storekey.h \
     stringutils.h \
@@ -137,6 +148,7 @@ HEADERS += \
     temporaryfile.h \
     textcodec.h \
     threadutils.h \
+    tracewriter.h \
     treemodel.h \
     utils_global.h \
     utils.hpp \
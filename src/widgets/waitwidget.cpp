@@ -16,8 +16,6 @@ public:
         processBar->setMaximumHeight(5);
         processBar->setTextVisible(false);
         processBar->setRange(0, 100);
-
-        timer = new QTimer(q_ptr);
     }
 
     void setupUI()
@@ -30,7 +28,6 @@ public:
 
     QWidget *q_ptr;
     QProgressBar *processBar;
-    QTimer *timer;
 };
 
 WaitWidget::WaitWidget()
@@ -41,30 +38,27 @@ WaitWidget::WaitWidget()
     //setAttribute(Qt::WA_StyledBackground);
     setAttribute(Qt::WA_TranslucentBackground);
     d_ptr->setupUI();
-    connect(d_ptr->timer, &QTimer::timeout, this, &WaitWidget::updateProgressBar);
-    d_ptr->timer->start(100);
     resize(600, 5);
     Utils::windowCenter(this);
 }
 
 WaitWidget::~WaitWidget() {}
 
-void WaitWidget::fullProgressBar()
+void WaitWidget::setProgress(int value, int maximum)
 {
-    int value = d_ptr->processBar->value();
-    if (value < 100) {
-        d_ptr->processBar->setValue(100);
+    if (maximum <= 0) {
+        return;
     }
+    d_ptr->processBar->setValue(qBound(0, value * 100 / maximum, 100));
+    d_ptr->processBar->repaint();
 }
 
-void WaitWidget::updateProgressBar()
+void WaitWidget::fullProgressBar()
 {
-    int value = d_ptr->processBar->value() + 5;
-    if (value >= 95) {
-        d_ptr->timer->stop();
-        return;
+    int value = d_ptr->processBar->value();
+    if (value < 100) {
+        d_ptr->processBar->setValue(100);
     }
-    d_ptr->processBar->setValue(value);
 }
 
 } // namespace Widgets
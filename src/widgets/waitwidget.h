@@ -14,11 +14,10 @@ public:
     explicit WaitWidget();
     ~WaitWidget() override;
 
+    // 启动过程中已完成的步骤数
+    void setProgress(int value, int maximum);
     void fullProgressBar();
 
-private slots:
-    void updateProgressBar();
-
 private:
     class WaitWidgetPrivate;
     QScopedPointer<WaitWidgetPrivate> d_ptr;